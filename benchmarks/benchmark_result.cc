@@ -0,0 +1,126 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark_result.h"
+#include <regex>
+#include "algo/format.h"
+#include "algo/range.h"
+#include "algo/str.h"
+#include "err.h"
+#include "io/file_byte_stream.h"
+
+using namespace au;
+using namespace au::bench;
+
+double BenchmarkResult::get_mb_per_second() const
+{
+    return seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0;
+}
+
+double BenchmarkResult::get_entries_per_second() const
+{
+    return seconds > 0 ? entries / seconds : 0;
+}
+
+void bench::write_results(
+    const io::path &path, const std::vector<BenchmarkResult> &results)
+{
+    // one result per line, so that read_results() doesn't need a full JSON
+    // parser
+    io::FileByteStream output_stream(path, io::FileMode::Write);
+    output_stream.write("{\n    \"results\": [\n"_b);
+    for (const auto i : algo::range(results.size()))
+    {
+        const auto &result = results[i];
+        output_stream.write(algo::format(
+            "        {"
+                "\"decoder\": \"%s\", "
+                "\"file\": \"%s\", "
+                "\"phase\": \"%s\", "
+                "\"iterations\": %d, "
+                "\"seconds\": %.09f, "
+                "\"bytes\": %llu, "
+                "\"entries\": %d, "
+                "\"mb_per_s\": %.03f, "
+                "\"entries_per_s\": %.03f"
+            "}%s\n",
+            algo::escape_json(result.decoder).c_str(),
+            algo::escape_json(result.file).c_str(),
+            algo::escape_json(result.phase).c_str(),
+            static_cast<int>(result.iterations),
+            result.seconds,
+            static_cast<unsigned long long>(result.bytes),
+            static_cast<int>(result.entries),
+            result.get_mb_per_second(),
+            result.get_entries_per_second(),
+            i + 1 == static_cast<int>(results.size()) ? "" : ","));
+    }
+    output_stream.write("    ]\n}\n"_b);
+}
+
+std::vector<BenchmarkResult> bench::read_results(const io::path &path)
+{
+    static const std::regex string_regex(
+        R"re("(decoder|file|phase)": "((?:[^"\\]|\\.)*)")re");
+    static const std::regex number_regex(
+        R"re("(iterations|seconds|bytes|entries)": ([0-9.eE+-]+))re");
+
+    io::FileByteStream input_stream(path, io::FileMode::Read);
+    std::vector<BenchmarkResult> results;
+    for (const auto &line : algo::split(
+        input_stream.read_to_eof().str(), '\n', false))
+    {
+        if (line.find("\"decoder\"") == std::string::npos)
+            continue;
+
+        BenchmarkResult result;
+        result.iterations = 0;
+        result.seconds = 0;
+        result.bytes = 0;
+        result.entries = 0;
+
+        for (std::sregex_iterator it(
+                line.begin(), line.end(), string_regex), end;
+            it != end;
+            ++it)
+        {
+            const auto key = (*it)[1].str();
+            const auto value = algo::unescape_json((*it)[2].str());
+            if (key == "decoder") result.decoder = value;
+            else if (key == "file") result.file = value;
+            else if (key == "phase") result.phase = value;
+        }
+
+        for (std::sregex_iterator it(
+                line.begin(), line.end(), number_regex), end;
+            it != end;
+            ++it)
+        {
+            const auto key = (*it)[1].str();
+            const auto value = std::stod((*it)[2].str());
+            if (key == "iterations") result.iterations = value;
+            else if (key == "seconds") result.seconds = value;
+            else if (key == "bytes") result.bytes = value;
+            else if (key == "entries") result.entries = value;
+        }
+
+        if (result.decoder.empty() || result.phase.empty())
+            throw err::CorruptDataError("Malformed benchmark result: " + line);
+        results.push_back(result);
+    }
+    return results;
+}
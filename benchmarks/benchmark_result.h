@@ -0,0 +1,47 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "io/path.h"
+#include "types.h"
+
+namespace au {
+namespace bench {
+
+    struct BenchmarkResult final
+    {
+        double get_mb_per_second() const;
+        double get_entries_per_second() const;
+
+        std::string decoder;
+        std::string file;
+        std::string phase;
+        size_t iterations;
+        double seconds; // per iteration
+        uoff_t bytes;   // per iteration
+        size_t entries; // per iteration
+    };
+
+    void write_results(
+        const io::path &path, const std::vector<BenchmarkResult> &results);
+
+    std::vector<BenchmarkResult> read_results(const io::path &path);
+
+} }
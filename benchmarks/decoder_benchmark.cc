@@ -0,0 +1,185 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "decoder_benchmark.h"
+#include <chrono>
+#include <functional>
+#include "dec/idecoder_visitor.h"
+#include "enc/microsoft/wav_audio_encoder.h"
+#include "enc/png/png_image_encoder.h"
+
+using namespace au;
+using namespace au::bench;
+
+namespace
+{
+    // Reports the number of bytes and entries processed in one iteration.
+    using PhaseCallback = std::function<void(uoff_t &bytes, size_t &entries)>;
+
+    class BenchmarkVisitor final : public dec::IDecoderVisitor
+    {
+    public:
+        BenchmarkVisitor(
+            const Logger &logger,
+            const std::string &decoder_name,
+            io::File &input_file,
+            const double min_time);
+
+        void visit(const dec::BaseArchiveDecoder &decoder) override;
+        void visit(const dec::BaseFileDecoder &decoder) override;
+        void visit(const dec::BaseImageDecoder &decoder) override;
+        void visit(const dec::BaseAudioDecoder &decoder) override;
+
+        std::vector<BenchmarkResult> results;
+
+    private:
+        void measure(const std::string &phase, const PhaseCallback callback);
+
+        const Logger &logger;
+        const std::string decoder_name;
+        io::File &input_file;
+        const double min_time;
+    };
+}
+
+BenchmarkVisitor::BenchmarkVisitor(
+    const Logger &logger,
+    const std::string &decoder_name,
+    io::File &input_file,
+    const double min_time) :
+        logger(logger),
+        decoder_name(decoder_name),
+        input_file(input_file),
+        min_time(min_time)
+{
+}
+
+void BenchmarkVisitor::measure(
+    const std::string &phase, const PhaseCallback callback)
+{
+    BenchmarkResult result;
+    result.decoder = decoder_name;
+    result.file = input_file.path.str();
+    result.phase = phase;
+    result.iterations = 0;
+    result.bytes = 0;
+    result.entries = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do
+    {
+        callback(result.bytes, result.entries);
+        ++result.iterations;
+        elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin).count();
+    }
+    while (elapsed < min_time);
+
+    result.seconds = elapsed / result.iterations;
+    results.push_back(result);
+}
+
+void BenchmarkVisitor::visit(const dec::BaseArchiveDecoder &decoder)
+{
+    const auto input_size = input_file.stream.size();
+    measure("read_meta", [&](uoff_t &bytes, size_t &entries)
+    {
+        const auto meta = decoder.read_meta(logger, input_file);
+        bytes = input_size;
+        entries = meta->entries.size();
+    });
+
+    const auto meta = decoder.read_meta(logger, input_file);
+    measure("read_file", [&](uoff_t &bytes, size_t &entries)
+    {
+        bytes = 0;
+        entries = 0;
+        for (const auto &entry : meta->entries)
+        {
+            const auto output_file
+                = decoder.read_file(logger, input_file, *meta, *entry);
+            if (!output_file)
+                continue;
+            bytes += output_file->stream.size();
+            ++entries;
+        }
+    });
+}
+
+void BenchmarkVisitor::visit(const dec::BaseFileDecoder &decoder)
+{
+    const auto input_size = input_file.stream.size();
+    measure("decode", [&](uoff_t &bytes, size_t &entries)
+    {
+        decoder.decode(logger, input_file);
+        bytes = input_size;
+        entries = 1;
+    });
+}
+
+void BenchmarkVisitor::visit(const dec::BaseImageDecoder &decoder)
+{
+    const auto input_size = input_file.stream.size();
+    measure("decode", [&](uoff_t &bytes, size_t &entries)
+    {
+        decoder.decode(logger, input_file);
+        bytes = input_size;
+        entries = 1;
+    });
+
+    const auto image = decoder.decode(logger, input_file);
+    const enc::png::PngImageEncoder encoder;
+    measure("encode_png", [&](uoff_t &bytes, size_t &entries)
+    {
+        encoder.encode(logger, image, input_file.path);
+        bytes = image.width() * image.height() * 4;
+        entries = 1;
+    });
+}
+
+void BenchmarkVisitor::visit(const dec::BaseAudioDecoder &decoder)
+{
+    const auto input_size = input_file.stream.size();
+    measure("decode", [&](uoff_t &bytes, size_t &entries)
+    {
+        decoder.decode(logger, input_file);
+        bytes = input_size;
+        entries = 1;
+    });
+
+    const auto audio = decoder.decode(logger, input_file);
+    const enc::microsoft::WavAudioEncoder encoder;
+    measure("encode_wav", [&](uoff_t &bytes, size_t &entries)
+    {
+        encoder.encode(logger, audio, input_file.path);
+        bytes = audio.samples.size();
+        entries = 1;
+    });
+}
+
+std::vector<BenchmarkResult> bench::run_decoder_benchmark(
+    const Logger &logger,
+    const std::string &decoder_name,
+    const dec::IDecoder &decoder,
+    io::File &input_file,
+    const double min_time)
+{
+    BenchmarkVisitor visitor(logger, decoder_name, input_file, min_time);
+    decoder.accept(visitor);
+    return visitor.results;
+}
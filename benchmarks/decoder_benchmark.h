@@ -0,0 +1,36 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "benchmark_result.h"
+#include "dec/idecoder.h"
+#include "logger.h"
+
+namespace au {
+namespace bench {
+
+    // Runs every phase applicable to given decoder on given input file. Each
+    // phase is repeated until it takes at least min_time seconds in total.
+    std::vector<BenchmarkResult> run_decoder_benchmark(
+        const Logger &logger,
+        const std::string &decoder_name,
+        const dec::IDecoder &decoder,
+        io::File &input_file,
+        const double min_time);
+
+} }
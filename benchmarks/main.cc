@@ -0,0 +1,296 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <map>
+#include "algo/str.h"
+#include "arg_parser.h"
+#include "benchmark_result.h"
+#include "decoder_benchmark.h"
+#include "dec/registry.h"
+#include "entry_point.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "io/program_path.h"
+#include "logger.h"
+
+using namespace au;
+
+static const io::path fixtures_dir = "tests/dec";
+
+namespace
+{
+    struct Options final
+    {
+        std::string filter;
+        double min_time;
+        io::path json_path;
+        io::path baseline_path;
+        double threshold;
+    };
+
+    struct Fixture final
+    {
+        std::string decoder_name;
+        io::path path;
+    };
+}
+
+static void register_cli_options(ArgParser &arg_parser)
+{
+    arg_parser.register_flag({"-h", "--help"})
+        ->set_description("Shows this message.");
+
+    arg_parser.register_switch({"--filter"})
+        ->set_value_name("TEXT")
+        ->set_description(
+            "Runs only the decoders whose names contain given text.");
+
+    arg_parser.register_switch({"--min-time"})
+        ->set_value_name("SECONDS")
+        ->set_description(
+            "Repeats each phase until it takes at least this long "
+            "(defaults to 0.1).");
+
+    arg_parser.register_switch({"--json"})
+        ->set_value_name("FILE")
+        ->set_description("Saves the results as JSON.");
+
+    arg_parser.register_switch({"--baseline"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Compares the results against JSON saved by an earlier run. "
+            "Exits with non-zero code if any phase got slower by more than "
+            "the threshold.");
+
+    arg_parser.register_switch({"--threshold"})
+        ->set_value_name("PERCENT")
+        ->set_description(
+            "Sets the allowed slowdown for --baseline (defaults to 10).");
+}
+
+static Options parse_cli_options(const ArgParser &arg_parser)
+{
+    Options options;
+    options.filter = arg_parser.has_switch("--filter")
+        ? arg_parser.get_switch("--filter")
+        : "";
+    options.min_time = arg_parser.has_switch("--min-time")
+        ? algo::from_string<float>(arg_parser.get_switch("--min-time"))
+        : 0.1;
+    if (arg_parser.has_switch("--json"))
+        options.json_path = arg_parser.get_switch("--json");
+    if (arg_parser.has_switch("--baseline"))
+        options.baseline_path = arg_parser.get_switch("--baseline");
+    options.threshold = arg_parser.has_switch("--threshold")
+        ? algo::from_string<float>(arg_parser.get_switch("--threshold"))
+        : 10;
+    return options;
+}
+
+// Test fixtures live in tests/dec/<vendor>/files/, and each one is matched
+// against the decoders of that vendor. Files that aren't recognized by
+// exactly one decoder are skipped.
+static std::vector<Fixture> collect_fixtures(
+    const dec::Registry &registry, const Options &options)
+{
+    const auto decoder_names = registry.get_decoder_names();
+    std::vector<Fixture> fixtures;
+    for (const auto &vendor_dir : io::directory_range(fixtures_dir))
+    {
+        const auto files_dir = vendor_dir / "files";
+        if (!io::is_directory(files_dir))
+            continue;
+
+        const auto prefix
+            = algo::replace_all(vendor_dir.name(), "_", "-") + "/";
+        std::set<std::string> vendor_decoders;
+        for (const auto &name : decoder_names)
+        {
+            if (name.compare(0, prefix.size(), prefix) != 0)
+                continue;
+            if (name.find(options.filter) == std::string::npos)
+                continue;
+            vendor_decoders.insert(name);
+        }
+        if (vendor_decoders.empty())
+            continue;
+
+        std::vector<io::path> paths;
+        for (const auto &path : io::recursive_directory_range(files_dir))
+            if (io::is_regular_file(path))
+                paths.push_back(path);
+        std::sort(paths.begin(), paths.end());
+
+        for (const auto &path : paths)
+        {
+            io::File input_file(path, io::FileMode::Read);
+            std::vector<std::string> matching_decoders;
+            for (const auto &name : registry.get_candidate_decoder_names(
+                vendor_decoders, input_file))
+            {
+                if (registry.get_decoder_prototype(name)
+                        ->is_recognized(input_file))
+                {
+                    matching_decoders.push_back(name);
+                }
+            }
+            if (matching_decoders.size() == 1)
+                fixtures.push_back({matching_decoders[0], path});
+        }
+    }
+    return fixtures;
+}
+
+// Decoder options, such as --plugin, are passed through like in arc_unpacker.
+static std::shared_ptr<dec::IDecoder> create_decoder(
+    const dec::Registry &registry,
+    const std::string &name,
+    const std::vector<std::string> &arguments)
+{
+    auto decoder = registry.create_decoder(name);
+    ArgParser decoder_arg_parser;
+    const auto decorators = decoder->get_arg_parser_decorators();
+    for (const auto &decorator : decorators)
+        decorator.register_cli_options(decoder_arg_parser);
+    decoder_arg_parser.parse(arguments);
+    for (const auto &decorator : decorators)
+        decorator.parse_cli_options(decoder_arg_parser);
+    return decoder;
+}
+
+static std::string get_result_key(const bench::BenchmarkResult &result)
+{
+    return result.decoder + "\n" + result.file + "\n" + result.phase;
+}
+
+static bool print_results(
+    const Logger &logger,
+    const std::vector<bench::BenchmarkResult> &results,
+    const std::vector<bench::BenchmarkResult> &baseline_results,
+    const double threshold)
+{
+    std::map<std::string, bench::BenchmarkResult> baseline;
+    for (const auto &result : baseline_results)
+        baseline[get_result_key(result)] = result;
+
+    bool regressed = false;
+    for (const auto &result : results)
+    {
+        logger.info(
+            "%-32s %-10s %10.2f MB/s %12.1f entries/s",
+            result.decoder.c_str(),
+            result.phase.c_str(),
+            result.get_mb_per_second(),
+            result.get_entries_per_second());
+
+        const auto it = baseline.find(get_result_key(result));
+        if (it != baseline.end() && it->second.seconds > 0)
+        {
+            const auto change
+                = (it->second.seconds / result.seconds - 1.0) * 100.0;
+            if (change < -threshold)
+            {
+                regressed = true;
+                logger.err("  %+7.1f%%", change);
+            }
+            else
+            {
+                logger.info("  %+7.1f%%", change);
+            }
+        }
+
+        logger.info("  %s\n", result.file.c_str());
+    }
+    return !regressed;
+}
+
+ENTRY_POINT(
+    Logger logger;
+    try
+    {
+        io::set_program_path_from_arg(arguments[0]);
+        arguments.erase(arguments.begin());
+
+        ArgParser arg_parser;
+        register_cli_options(arg_parser);
+        arg_parser.parse(arguments);
+        const auto options = parse_cli_options(arg_parser);
+
+        if (arg_parser.has_flag("-h") || arg_parser.has_flag("--help"))
+        {
+            logger.info(
+                "Usage: run_benchmarks [options] [dec_options]\n\n"
+                "Must be run from within the repository root directory.\n\n"
+                "[options] can be:\n\n");
+            arg_parser.print_help(logger);
+            return 0;
+        }
+
+        Logger decoder_logger;
+        decoder_logger.mute();
+
+        const auto &registry = dec::Registry::instance();
+        std::vector<bench::BenchmarkResult> results;
+        for (const auto &fixture : collect_fixtures(registry, options))
+        {
+            try
+            {
+                io::FileByteStream input_stream(
+                    fixture.path, io::FileMode::Read);
+                io::File input_file(fixture.path, input_stream.read_to_eof());
+                const auto decoder = create_decoder(
+                    registry, fixture.decoder_name, arguments);
+                const auto fixture_results = bench::run_decoder_benchmark(
+                    decoder_logger,
+                    fixture.decoder_name,
+                    *decoder,
+                    input_file,
+                    options.min_time);
+                results.insert(
+                    results.end(),
+                    fixture_results.begin(),
+                    fixture_results.end());
+            }
+            catch (const std::exception &e)
+            {
+                logger.warn(
+                    "%s: %s (%s)\n",
+                    fixture.decoder_name.c_str(),
+                    fixture.path.c_str(),
+                    e.what());
+            }
+        }
+
+        const auto baseline_results = options.baseline_path.str().empty()
+            ? std::vector<bench::BenchmarkResult>()
+            : bench::read_results(options.baseline_path);
+
+        const auto success = print_results(
+            logger, results, baseline_results, options.threshold);
+
+        if (!options.json_path.str().empty())
+            bench::write_results(options.json_path, results);
+
+        return success ? 0 : 1;
+    }
+    catch (const std::exception &e)
+    {
+        logger.err("Error: " + std::string(e.what()) + "\n");
+        return 1;
+    }
+)
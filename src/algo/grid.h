@@ -20,6 +20,7 @@
 #include <vector>
 #include "algo/range.h"
 #include "err.h"
+#include "types.h"
 
 namespace au {
 namespace algo {
@@ -28,17 +29,15 @@ namespace algo {
     {
     public:
         Grid(const size_t width, const size_t height)
-            : content(width * height), _width(width), _height(height)
+            : content(width * height, T()), _width(width), _height(height)
         {
             if (!width || !height)
                 throw err::BadDataSizeError();
         }
 
-        Grid(const Grid &other) : Grid(other.width(), other.height())
+        Grid(const Grid &other) :
+            content(other.content), _width(other._width), _height(other._height)
         {
-            for (const auto y : algo::range(_height))
-            for (const auto x : algo::range(_width))
-                at(x, y) = other.at(x, y);
         }
 
         virtual ~Grid()
@@ -86,7 +85,7 @@ namespace algo {
         }
 
     protected:
-        std::vector<T> content;
+        std::vector<T, au::priv::BstrAllocator<T>> content;
         size_t _width, _height;
     };
 
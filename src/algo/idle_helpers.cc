@@ -0,0 +1,148 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/idle_helpers.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace au;
+using namespace au::algo;
+
+namespace
+{
+    struct Request final
+    {
+        std::function<void()> function;
+        size_t max_helpers;
+        size_t active_helpers;
+        bool finished;
+    };
+
+    struct Listener final
+    {
+        const void *key;
+        std::function<void()> callback;
+    };
+}
+
+struct HelpRequest::Priv final
+{
+    Request request;
+};
+
+static std::mutex request_mutex;
+static std::condition_variable helper_done;
+static std::vector<Request*> requests;
+
+// separate from the above, as the callbacks take the pools' own locks, which
+// the pools may hold while asking for pending requests
+static std::mutex listener_mutex;
+static std::vector<Listener> listeners;
+
+static bool can_help(const Request &request)
+{
+    return !request.finished && request.active_helpers < request.max_helpers;
+}
+
+HelpRequest::HelpRequest(
+    const std::function<void()> &function, const size_t max_helpers)
+        : p(new Priv())
+{
+    p->request.function = function;
+    p->request.max_helpers = max_helpers;
+    p->request.active_helpers = 0;
+    p->request.finished = false;
+    if (!max_helpers)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(request_mutex);
+        requests.push_back(&p->request);
+    }
+    std::lock_guard<std::mutex> lock(listener_mutex);
+    for (const auto &listener : listeners)
+        listener.callback();
+}
+
+HelpRequest::~HelpRequest()
+{
+    std::unique_lock<std::mutex> lock(request_mutex);
+    const auto it = std::find(requests.begin(), requests.end(), &p->request);
+    if (it != requests.end())
+        requests.erase(it);
+    helper_done.wait(lock, [&]() { return !p->request.active_helpers; });
+}
+
+bool algo::help_with_pending_request()
+{
+    Request *request = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(request_mutex);
+        for (const auto candidate : requests)
+        {
+            if (can_help(*candidate))
+            {
+                request = candidate;
+                break;
+            }
+        }
+        if (!request)
+            return false;
+        request->active_helpers++;
+    }
+
+    request->function();
+
+    {
+        std::lock_guard<std::mutex> lock(request_mutex);
+        request->active_helpers--;
+        request->finished = true;
+    }
+    helper_done.notify_all();
+    return true;
+}
+
+bool algo::has_pending_help_requests()
+{
+    std::lock_guard<std::mutex> lock(request_mutex);
+    for (const auto request : requests)
+    {
+        if (can_help(*request))
+            return true;
+    }
+    return false;
+}
+
+void algo::add_help_listener(
+    const void *key, const std::function<void()> &callback)
+{
+    std::lock_guard<std::mutex> lock(listener_mutex);
+    listeners.push_back({key, callback});
+}
+
+void algo::remove_help_listener(const void *key)
+{
+    std::lock_guard<std::mutex> lock(listener_mutex);
+    listeners.erase(
+        std::remove_if(
+            listeners.begin(),
+            listeners.end(),
+            [key](const Listener &listener) { return listener.key == key; }),
+        listeners.end());
+}
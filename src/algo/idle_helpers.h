@@ -0,0 +1,58 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace au {
+namespace algo {
+
+    // Lets a long job borrow threads that a pool would otherwise leave idle,
+    // rather than spawn threads of its own. While a HelpRequest is alive,
+    // idle pool threads run its function, at most max_helpers of them at
+    // a time. The function must not throw, and must return only once there
+    // is nothing left for it to do; from then on no more helpers are sent.
+    // The requesting thread is expected to take part in the work as well, so
+    // that the job completes even when no thread is idle.
+    class HelpRequest final
+    {
+    public:
+        HelpRequest(
+            const std::function<void()> &function, const size_t max_helpers);
+
+        // Withdraws the request and waits for the helpers still running it.
+        ~HelpRequest();
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+    // For thread pools: runs a pending request on the calling thread.
+    // Returns false if no request can take another helper.
+    bool help_with_pending_request();
+    bool has_pending_help_requests();
+
+    // The callback is called whenever a request is made, so that the pool
+    // can wake up its idle threads.
+    void add_help_listener(
+        const void *key, const std::function<void()> &callback);
+    void remove_help_listener(const void *key);
+
+} }
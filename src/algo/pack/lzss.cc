@@ -178,7 +178,8 @@ bstr algo::pack::lzss_decompress(
         = algo::make_cyclic_ptr(dict.data(), dict.size())
         + settings.initial_dictionary_pos;
 
-    bstr output(output_size);
+    bstr output;
+    output.resize_uninitialized(output_size);
     auto output_ptr = algo::make_ptr(output);
     while (output_ptr.left())
     {
@@ -217,7 +218,8 @@ bstr algo::pack::lzss_decompress(
         = algo::make_cyclic_ptr(dict.data(), dict.size())
         + settings.initial_dictionary_pos;
 
-    bstr output(output_size);
+    bstr output;
+    output.resize_uninitialized(output_size);
     auto output_ptr = algo::make_ptr(output);
     auto input_ptr = algo::make_ptr(input);
 
@@ -255,6 +257,9 @@ bstr algo::pack::lzss_decompress(
             }
         }
     }
+    // truncated input leaves the rest of the output zeroed
+    while (output_ptr.left())
+        *output_ptr++ = 0;
     return output;
 }
 
@@ -17,6 +17,7 @@
 
 #include "algo/pack/zlib.h"
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <zlib.h>
 #include "algo/format.h"
@@ -28,13 +29,7 @@ using namespace au::algo::pack;
 
 static const int buffer_size = 8192;
 
-static bstr process_stream(
-    io::BaseByteStream &input_stream,
-    const ZlibKind kind,
-    const std::function<int(z_stream &s, const int window_bits)> &init_func,
-    const std::function<int(z_stream &s)> &process_func,
-    const std::function<int(z_stream &s)> &end_func,
-    const std::string &error_message)
+static int get_window_bits(const ZlibKind kind)
 {
     const int window_bits
         = kind == ZlibKind::RawDeflate ? -MAX_WBITS
@@ -43,13 +38,26 @@ static bstr process_stream(
         : 0;
     if (!window_bits)
         throw std::logic_error("Bad zlib kind");
+    return window_bits;
+}
+
+static bstr process_stream(
+    io::BaseByteStream &input_stream,
+    const ZlibKind kind,
+    const std::function<int(z_stream &s, const int window_bits)> &init_func,
+    const std::function<int(z_stream &s)> &process_func,
+    const std::function<int(z_stream &s)> &end_func,
+    const std::string &error_message)
+{
+    const auto window_bits = get_window_bits(kind);
 
     z_stream s;
     std::memset(&s, 0, sizeof(s));
     if (init_func(s, window_bits) != Z_OK)
         throw std::logic_error("Failed to initialize zlib stream");
 
-    bstr output, input_chunk, output_chunk(buffer_size);
+    bstr output, input_chunk, output_chunk;
+    output_chunk.resize_uninitialized(buffer_size);
     size_t written = 0;
     int ret;
     const auto initial_pos = input_stream.pos();
@@ -120,6 +128,110 @@ bstr algo::pack::zlib_inflate(const bstr &input, const ZlibKind kind)
     return ::zlib_inflate(input_stream, kind);
 }
 
+void algo::pack::zlib_inflate(
+    io::BaseByteStream &input_stream,
+    u8 *output_ptr,
+    const size_t output_size,
+    const ZlibKind kind)
+{
+    z_stream s;
+    std::memset(&s, 0, sizeof(s));
+    if (inflateInit2(&s, get_window_bits(kind)) != Z_OK)
+        throw std::logic_error("Failed to initialize zlib stream");
+
+    // in-memory streams are inflated in a single call; others are read in
+    // chunks. Either way the output lands directly in the caller's buffer.
+    static const size_t max_window = std::numeric_limits<uInt>::max();
+    const auto initial_pos = input_stream.pos();
+    const auto input_size = input_stream.left();
+    const auto input_view = input_stream.get_view(initial_pos, input_size);
+    bstr input_chunk;
+    size_t input_offset = 0;
+    size_t output_offset = 0;
+    u8 overflow;
+    int ret;
+    do
+    {
+        if (s.avail_in == 0 && input_offset < input_size)
+        {
+            const auto chunk_size = std::min<size_t>(
+                input_size - input_offset,
+                input_view ? max_window : buffer_size);
+            if (input_view)
+            {
+                s.next_in = const_cast<Bytef*>(input_view + input_offset);
+            }
+            else
+            {
+                input_chunk = input_stream.read(chunk_size);
+                s.next_in = input_chunk.get<Bytef>();
+            }
+            s.avail_in = chunk_size;
+            input_offset += chunk_size;
+        }
+
+        if (s.avail_out == 0)
+        {
+            // once the buffer is full, any further output means the stream
+            // is larger than announced
+            if (output_offset < output_size)
+            {
+                const auto window_size = std::min<size_t>(
+                    output_size - output_offset, max_window);
+                s.next_out = output_ptr + output_offset;
+                s.avail_out = window_size;
+                output_offset += window_size;
+            }
+            else
+            {
+                s.next_out = &overflow;
+                s.avail_out = 1;
+            }
+        }
+
+        ret = inflate(&s, Z_NO_FLUSH);
+    }
+    while (ret == Z_OK && s.next_out != &overflow + 1);
+
+    input_stream.seek(initial_pos + input_offset - s.avail_in);
+    const auto output_written = s.next_out == &overflow + 1
+        ? output_size + 1
+        : output_offset - s.avail_out;
+    const auto error_message = std::string(s.msg ? s.msg : "unknown error");
+    inflateEnd(&s);
+
+    if (output_written != output_size
+        && (ret == Z_STREAM_END || output_written > output_size))
+    {
+        throw err::BadDataSizeError();
+    }
+    if (ret != Z_STREAM_END)
+    {
+        throw err::CorruptDataError(algo::format(
+            "Failed to inflate zlib stream (%s near %x)",
+            error_message.c_str(),
+            static_cast<unsigned int>(input_offset - s.avail_in)));
+    }
+}
+
+bstr algo::pack::zlib_inflate(
+    io::BaseByteStream &input_stream,
+    const size_t output_size,
+    const ZlibKind kind)
+{
+    bstr output;
+    output.resize_uninitialized(output_size);
+    ::zlib_inflate(input_stream, output.get<u8>(), output_size, kind);
+    return output;
+}
+
+bstr algo::pack::zlib_inflate(
+    const bstr &input, const size_t output_size, const ZlibKind kind)
+{
+    io::MemoryByteStream input_stream(input);
+    return ::zlib_inflate(input_stream, output_size, kind);
+}
+
 bstr algo::pack::zlib_deflate(
     const bstr &input,
     const ZlibKind kind,
@@ -39,6 +39,25 @@ namespace pack {
     bstr zlib_inflate(
         const bstr &input, const ZlibKind kind = ZlibKind::PlainZlib);
 
+    // Inflate a stream whose decompressed size is known in advance straight
+    // into the caller's buffer. Throws if the stream inflates to a different
+    // size.
+    void zlib_inflate(
+        io::BaseByteStream &input_stream,
+        u8 *output_ptr,
+        const size_t output_size,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
+    bstr zlib_inflate(
+        io::BaseByteStream &input_stream,
+        const size_t output_size,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
+    bstr zlib_inflate(
+        const bstr &input,
+        const size_t output_size,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
     bstr zlib_deflate(
         const bstr &input,
         const ZlibKind kind = ZlibKind::PlainZlib,
@@ -134,6 +134,52 @@ std::string algo::replace_all(
     return output;
 }
 
+std::string algo::escape_json(const std::string &input)
+{
+    std::string output;
+    for (const auto c : input)
+    {
+        if (c == '"' || c == '\\')
+        {
+            output += '\\';
+            output += c;
+        }
+        else if (static_cast<u8>(c) < 0x20)
+            output += algo::format("\\u%04x", static_cast<u8>(c));
+        else
+            output += c;
+    }
+    return output;
+}
+
+std::string algo::unescape_json(const std::string &input)
+{
+    std::string output;
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        if (input[i] != '\\' || i + 1 == input.size())
+        {
+            output += input[i];
+            continue;
+        }
+        const auto c = input[++i];
+        if (c == 'b') output += '\b';
+        else if (c == 'f') output += '\f';
+        else if (c == 'n') output += '\n';
+        else if (c == 'r') output += '\r';
+        else if (c == 't') output += '\t';
+        else if (c == 'u' && i + 4 < input.size())
+        {
+            const auto code = std::stoul(input.substr(i + 1, 4), nullptr, 16);
+            output += static_cast<char>(code);
+            i += 4;
+        }
+        else
+            output += c;
+    }
+    return output;
+}
+
 
 namespace au {
 namespace algo {
@@ -143,6 +189,11 @@ namespace algo {
         return boost::lexical_cast<int>(input);
     }
 
+    template<> uoff_t from_string(const std::string &input)
+    {
+        return boost::lexical_cast<uoff_t>(input);
+    }
+
     template<> float from_string(const std::string &input)
     {
         return boost::lexical_cast<float>(input);
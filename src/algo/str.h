@@ -48,6 +48,10 @@ namespace algo {
         const std::string &from,
         const std::string &to);
 
+    std::string escape_json(const std::string &input);
+
+    std::string unescape_json(const std::string &input);
+
     template<typename T> T from_string(const std::string &input);
 
 } }
@@ -0,0 +1,215 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "arena.h"
+#include <atomic>
+#include <vector>
+#include "types.h"
+
+using namespace au;
+
+const size_t Arena::block_size = 256 * 1024;
+const size_t Arena::max_allocation_size = 16 * 1024;
+
+static const size_t max_spare_blocks_per_thread = 4;
+
+namespace
+{
+    // The arena holds one reference to each of its blocks, and every live
+    // buffer holds one more.
+    struct Block final
+    {
+        std::atomic<size_t> ref_count;
+        size_t used_size;
+
+        u8 *data();
+    };
+
+    struct SpareBlocks final
+    {
+        ~SpareBlocks();
+
+        std::vector<Block*> blocks;
+    };
+}
+
+static const size_t block_header_size
+    = (sizeof(Block) + Arena::header_size - 1) & ~(Arena::header_size - 1);
+
+static thread_local Arena *current_arena = nullptr;
+static thread_local SpareBlocks spare_blocks;
+static thread_local bool spare_blocks_destroyed = false;
+
+u8 *Block::data()
+{
+    return reinterpret_cast<u8*>(this) + block_header_size;
+}
+
+static void delete_block(Block *block)
+{
+    block->~Block();
+    ::operator delete(block);
+}
+
+SpareBlocks::~SpareBlocks()
+{
+    for (const auto block : blocks)
+        delete_block(block);
+    spare_blocks_destroyed = true;
+}
+
+static Block *create_block()
+{
+    if (!spare_blocks_destroyed && !spare_blocks.blocks.empty())
+    {
+        const auto block = spare_blocks.blocks.back();
+        spare_blocks.blocks.pop_back();
+        block->ref_count = 1;
+        return block;
+    }
+    const auto memory = ::operator new(block_header_size + Arena::block_size);
+    const auto block = new (memory) Block;
+    block->ref_count = 1;
+    block->used_size = 0;
+    return block;
+}
+
+static void release_block(Block *block)
+{
+    if (block->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    if (!spare_blocks_destroyed
+        && spare_blocks.blocks.size() < max_spare_blocks_per_thread)
+    {
+        block->used_size = 0;
+        spare_blocks.blocks.push_back(block);
+        return;
+    }
+    delete_block(block);
+}
+
+static bool is_unused(const Block *block)
+{
+    return block->ref_count.load(std::memory_order_acquire) == 1;
+}
+
+static Block *&get_header(void *ptr)
+{
+    const auto header = static_cast<u8*>(ptr) - Arena::header_size;
+    return *reinterpret_cast<Block**>(header);
+}
+
+struct Arena::Priv final
+{
+    Block *get_block(const size_t size);
+
+    std::vector<Block*> blocks;
+};
+
+Block *Arena::Priv::get_block(const size_t size)
+{
+    // the last block is the one being filled
+    if (!blocks.empty())
+    {
+        const auto block = blocks.back();
+        if (is_unused(block))
+            block->used_size = 0;
+        if (block->used_size + size <= block_size)
+            return block;
+    }
+    for (auto &block : blocks)
+    {
+        if (!is_unused(block))
+            continue;
+        block->used_size = 0;
+        std::swap(block, blocks.back());
+        return blocks.back();
+    }
+    blocks.push_back(create_block());
+    return blocks.back();
+}
+
+Arena::Scope::Scope(Arena &arena) : previous_arena(current_arena)
+{
+    current_arena = &arena;
+}
+
+Arena::Scope::~Scope()
+{
+    current_arena = previous_arena;
+}
+
+Arena::Arena() : p(new Priv())
+{
+}
+
+Arena::~Arena()
+{
+    for (const auto block : p->blocks)
+        release_block(block);
+}
+
+Arena *Arena::current()
+{
+    return current_arena;
+}
+
+void *Arena::allocate(const size_t size)
+{
+    if (size > max_allocation_size)
+        return nullptr;
+    const auto aligned_size
+        = header_size + ((size + header_size - 1) & ~(header_size - 1));
+    const auto block = p->get_block(aligned_size);
+    const auto ptr = block->data() + block->used_size + header_size;
+    block->used_size += aligned_size;
+    block->ref_count.fetch_add(1, std::memory_order_relaxed);
+    get_header(ptr) = block;
+    return ptr;
+}
+
+bool Arena::owns(const void *ptr)
+{
+    return get_header(const_cast<void*>(ptr)) != nullptr;
+}
+
+void Arena::deallocate(void *ptr)
+{
+    release_block(get_header(ptr));
+}
+
+void Arena::reset()
+{
+    for (const auto block : p->blocks)
+    {
+        if (is_unused(block))
+            block->used_size = 0;
+    }
+}
+
+size_t Arena::block_count() const
+{
+    return p->blocks.size();
+}
+
+size_t Arena::used_size() const
+{
+    size_t ret = 0;
+    for (const auto block : p->blocks)
+        ret += block->used_size;
+    return ret;
+}
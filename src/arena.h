@@ -0,0 +1,73 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+
+namespace au {
+
+    // Monotonic allocator for short-lived buffers. While an Arena::Scope is
+    // active, small bstr and algo::Grid buffers created on that thread are
+    // carved out of the arena's blocks instead of the global heap. A block is
+    // reused from the start once every buffer carved out of it is freed.
+    //
+    // Buffers may outlive the arena and may be freed on any thread; the
+    // block they live in is released together with the last of them.
+    class Arena final
+    {
+    public:
+        class Scope final
+        {
+        public:
+            Scope(Arena &arena);
+            ~Scope();
+
+        private:
+            Arena *previous_arena;
+        };
+
+        static constexpr size_t header_size = 16;
+        static const size_t block_size;
+        static const size_t max_allocation_size;
+
+        Arena();
+        ~Arena();
+
+        // Arena of the innermost active scope on this thread, or nullptr.
+        static Arena *current();
+
+        // Returns nullptr if the size exceeds max_allocation_size. The
+        // returned memory is 16-byte aligned and preceded by a header whose
+        // first word is non-null; plain heap buffers handed out next to it
+        // must store nullptr there so that owns() can tell them apart.
+        void *allocate(const size_t size);
+        static bool owns(const void *ptr);
+        static void deallocate(void *ptr);
+
+        // Rewinds the blocks that have no live buffers left.
+        void reset();
+
+        size_t block_count() const;
+        size_t used_size() const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+}
@@ -74,4 +74,5 @@ std::vector<std::string> DskArchiveDecoder::get_linked_formats() const
     return {"abogado/kg", "abogado/v"};
 }
 
-static auto _ = dec::register_decoder<DskArchiveDecoder>("abogado/dsk");
+static auto _ = dec::register_decoder<DskArchiveDecoder>("abogado/dsk")
+    .add_extension("DSK");
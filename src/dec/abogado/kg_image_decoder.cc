@@ -223,4 +223,5 @@ res::Image KgImageDecoder::decode_impl(
 }
 
 static auto _
-    = dec::register_decoder<KgImageDecoder>("abogado/kg");
+    = dec::register_decoder<KgImageDecoder>("abogado/kg")
+    .add_magic(magic);
@@ -91,4 +91,5 @@ std::vector<std::string> WadArchiveDecoder::get_linked_formats() const
     return {"truevision/tga"};
 }
 
-static auto _ = dec::register_decoder<WadArchiveDecoder>("abstraction/wad");
+static auto _ = dec::register_decoder<WadArchiveDecoder>("abstraction/wad")
+    .add_magic(magic);
@@ -33,7 +33,7 @@ u32 CustomBitStream::read(const size_t bits)
         buffer >>= 1;
         if (!bits_available)
         {
-            buffer = input_stream->read<u8>();
+            buffer = read_byte();
             bits_available = 8;
         }
         value <<= 1;
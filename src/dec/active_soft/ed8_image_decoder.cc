@@ -103,4 +103,5 @@ res::Image Ed8ImageDecoder::decode_impl(
     return res::Image(width, height, output, palette);
 }
 
-static auto _ = dec::register_decoder<Ed8ImageDecoder>("active-soft/ed8");
+static auto _ = dec::register_decoder<Ed8ImageDecoder>("active-soft/ed8")
+    .add_magic(magic);
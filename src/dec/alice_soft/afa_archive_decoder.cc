@@ -55,7 +55,7 @@ std::unique_ptr<dec::ArchiveMeta> AfaArchiveDecoder::read_meta_impl(
 
     io::MemoryByteStream table_stream(
         algo::pack::zlib_inflate(
-            input_file.stream.read(table_size_comp)));
+            input_file.stream.read(table_size_comp), table_size_orig));
 
     auto meta = std::make_unique<ArchiveMeta>();
     for (const auto i : algo::range(file_count))
@@ -100,4 +100,5 @@ std::vector<std::string> AfaArchiveDecoder::get_linked_formats() const
     };
 }
 
-static auto _ = dec::register_decoder<AfaArchiveDecoder>("alice-soft/afa");
+static auto _ = dec::register_decoder<AfaArchiveDecoder>("alice-soft/afa")
+    .add_magic(magic1);
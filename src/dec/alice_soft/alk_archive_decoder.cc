@@ -67,4 +67,5 @@ std::vector<std::string> AlkArchiveDecoder::get_linked_formats() const
     return {"alice-soft/qnt"};
 }
 
-static auto _ = dec::register_decoder<AlkArchiveDecoder>("alice-soft/alk");
+static auto _ = dec::register_decoder<AlkArchiveDecoder>("alice-soft/alk")
+    .add_magic(magic);
@@ -167,4 +167,5 @@ res::Image QntImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<QntImageDecoder>("alice-soft/qnt");
+static auto _ = dec::register_decoder<QntImageDecoder>("alice-soft/qnt")
+    .add_magic(magic);
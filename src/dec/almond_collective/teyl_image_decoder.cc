@@ -38,4 +38,5 @@ res::Image TeylImageDecoder::decode_impl(
 }
 
 static auto _
-    = dec::register_decoder<TeylImageDecoder>("almond-collective/teyl");
+    = dec::register_decoder<TeylImageDecoder>("almond-collective/teyl")
+    .add_magic(magic);
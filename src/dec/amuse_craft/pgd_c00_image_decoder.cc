@@ -90,4 +90,5 @@ res::Image PgdC00ImageDecoder::decode_impl(
 }
 
 static auto _
-    = dec::register_decoder<PgdC00ImageDecoder>("amuse-craft/pgd-c00");
+    = dec::register_decoder<PgdC00ImageDecoder>("amuse-craft/pgd-c00")
+    .add_magic(magic, 24);
@@ -222,4 +222,5 @@ res::Image PgdGeImageDecoder::decode_impl(
         algo::format("Unknown filter: %d", filter_type));
 }
 
-static auto _ = dec::register_decoder<PgdGeImageDecoder>("amuse-craft/pgd-ge");
+static auto _ = dec::register_decoder<PgdGeImageDecoder>("amuse-craft/pgd-ge")
+    .add_magic(magic);
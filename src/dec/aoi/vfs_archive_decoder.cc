@@ -112,4 +112,5 @@ std::vector<std::string> VfsArchiveDecoder::get_linked_formats() const
     return {"aoi/iph", "aoi/aog", "aoi/agf", "microsoft/dds"};
 }
 
-static auto _ = dec::register_decoder<VfsArchiveDecoder>("aoi/vfs");
+static auto _ = dec::register_decoder<VfsArchiveDecoder>("aoi/vfs")
+    .add_magic(magic);
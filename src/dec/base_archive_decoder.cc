@@ -21,6 +21,7 @@
 #include "algo/format.h"
 #include "dec/idecoder_visitor.h"
 #include "err.h"
+#include "io/slice_byte_stream.h"
 
 using namespace au;
 using namespace au::dec;
@@ -109,3 +110,15 @@ std::unique_ptr<io::File> BaseArchiveDecoder::read_file(
     // wrapper reserved for future usage
     return read_file_impl(logger, input_file, e, m);
 }
+
+std::unique_ptr<io::File> BaseArchiveDecoder::open_plain_entry(
+    io::File &input_file, const PlainArchiveEntry &entry) const
+{
+    const auto input_size = input_file.stream.size();
+    if (entry.offset > input_size || entry.size > input_size - entry.offset)
+        throw err::EofError();
+    return std::make_unique<io::File>(
+        entry.path,
+        std::make_unique<io::SliceByteStream>(
+            input_file.stream, entry.offset, entry.size));
+}
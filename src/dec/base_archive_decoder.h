@@ -79,6 +79,12 @@ namespace dec {
             const ArchiveMeta &m,
             const ArchiveEntry &e) const = 0;
 
+        // Returns a file that reads the entry from the archive on demand, so
+        // that it is copied to the output in chunks rather than being loaded
+        // into memory first. Meant for entries stored verbatim.
+        std::unique_ptr<io::File> open_plain_entry(
+            io::File &input_file, const PlainArchiveEntry &entry) const;
+
     private:
         bool numeric_file_names;
     };
@@ -126,4 +126,5 @@ std::vector<std::string> BseFileDecoder::get_linked_formats() const
     return {"bgi/cbg", "bgi/dsc"};
 }
 
-static auto _ = dec::register_decoder<BseFileDecoder>("bgi/bse");
+static auto _ = dec::register_decoder<BseFileDecoder>("bgi/bse")
+    .add_magic(magic);
@@ -114,4 +114,5 @@ std::vector<std::string> BsaArchiveDecoder::get_linked_formats() const
     return {"bishop/bsc", "bishop/bsg"};
 }
 
-static auto _ = dec::register_decoder<BsaArchiveDecoder>("bishop/bsa");
+static auto _ = dec::register_decoder<BsaArchiveDecoder>("bishop/bsa")
+    .add_magic(magic);
@@ -60,4 +60,5 @@ std::unique_ptr<io::File> BscImageArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<BscImageArchiveDecoder>("bishop/bsc");
+static auto _ = dec::register_decoder<BscImageArchiveDecoder>("bishop/bsc")
+    .add_magic(magic);
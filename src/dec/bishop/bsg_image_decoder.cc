@@ -166,4 +166,5 @@ res::Image BsgImageDecoder::decode_impl(
     return *image;
 }
 
-static auto _ = dec::register_decoder<BsgImageDecoder>("bishop/bsg");
+static auto _ = dec::register_decoder<BsgImageDecoder>("bishop/bsg")
+    .add_magic(magic);
@@ -60,7 +60,8 @@ std::unique_ptr<dec::ArchiveMeta> BinArchiveDecoder::read_meta_impl(
     io::MemoryByteStream table_stream(algo::pack::zlib_inflate(
         input_file.stream
             .seek(input_file.stream.size() - 8 - table_size_comp)
-            .read(table_size_comp)));
+            .read(table_size_comp),
+        table_size_orig));
 
     const auto file_count = table_stream.read_le<u32>();
     auto meta = std::make_unique<ArchiveMeta>();
@@ -109,4 +110,5 @@ std::vector<std::string> BinArchiveDecoder::get_linked_formats() const
     return {"bluearrowgarden/images"};
 }
 
-static auto _ = dec::register_decoder<BinArchiveDecoder>("bluearrowgarden/bin");
+static auto _ = dec::register_decoder<BinArchiveDecoder>("bluearrowgarden/bin")
+    .add_extension("bin");
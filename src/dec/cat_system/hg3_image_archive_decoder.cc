@@ -114,8 +114,9 @@ static std::unique_ptr<res::Image> decode_img0000(
     const auto ctl_size_comp = input_stream.read_le<u32>();
     const auto ctl_size_orig = input_stream.read_le<u32>();
     const auto data = algo::pack::zlib_inflate(
-        input_stream.read(data_size_comp));
-    const auto ctl = algo::pack::zlib_inflate(input_stream.read(ctl_size_comp));
+        input_stream.read(data_size_comp), data_size_orig);
+    const auto ctl = algo::pack::zlib_inflate(
+        input_stream.read(ctl_size_comp), ctl_size_orig);
 
     io::LsbBitStream ctl_bit_stream(ctl);
     auto copy = ctl_bit_stream.read(1);
@@ -230,4 +231,5 @@ algo::NamingStrategy Hg3ImageArchiveDecoder::naming_strategy() const
     return algo::NamingStrategy::Sibling;
 }
 
-static auto _ = dec::register_decoder<Hg3ImageArchiveDecoder>("cat-system/hg3");
+static auto _ = dec::register_decoder<Hg3ImageArchiveDecoder>("cat-system/hg3")
+    .add_magic(magic);
@@ -248,4 +248,5 @@ std::vector<std::string> IntArchiveDecoder::get_linked_formats() const
     return {"cat-system/hg3"};
 }
 
-static auto _ = dec::register_decoder<IntArchiveDecoder>("cat-system/int");
+static auto _ = dec::register_decoder<IntArchiveDecoder>("cat-system/int")
+    .add_magic(magic);
@@ -148,4 +148,5 @@ std::unique_ptr<io::File> DatArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<DatArchiveDecoder>("chanchan/dat");
+static auto _ = dec::register_decoder<DatArchiveDecoder>("chanchan/dat")
+    .add_extension("dat");
@@ -61,4 +61,5 @@ std::unique_ptr<io::File> MykArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<MykArchiveDecoder>("cherry-soft/myk");
+static auto _ = dec::register_decoder<MykArchiveDecoder>("cherry-soft/myk")
+    .add_magic(magic);
@@ -72,4 +72,5 @@ std::vector<std::string> Afs2ArchiveDecoder::get_linked_formats() const
     return {"cri/hca"};
 }
 
-static auto _ = dec::register_decoder<Afs2ArchiveDecoder>("cri/afs2");
+static auto _ = dec::register_decoder<Afs2ArchiveDecoder>("cri/afs2")
+    .add_magic(magic);
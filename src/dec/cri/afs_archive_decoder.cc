@@ -68,4 +68,5 @@ std::vector<std::string> AfsArchiveDecoder::get_linked_formats() const
     return {"cri/afs"};
 }
 
-static auto _ = dec::register_decoder<AfsArchiveDecoder>("cri/afs");
+static auto _ = dec::register_decoder<AfsArchiveDecoder>("cri/afs")
+    .add_magic(magic);
@@ -410,12 +410,16 @@ std::unique_ptr<io::File> CpkArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    auto data = input_file.stream
+    input_file.stream.seek(entry->offset);
+    if (entry->size < layla_magic.size()
+        || input_file.stream.read(layla_magic.size()) != layla_magic)
+    {
+        return open_plain_entry(input_file, *entry);
+    }
+    const auto data = input_file.stream
         .seek(entry->offset)
         .read(entry->size);
-    if (data.substr(0, layla_magic.size()) == layla_magic)
-        data = decompress_layla(data);
-    return std::make_unique<io::File>(entry->path, data);
+    return std::make_unique<io::File>(entry->path, decompress_layla(data));
 }
 
 std::vector<std::string> CpkArchiveDecoder::get_linked_formats() const
@@ -423,4 +427,5 @@ std::vector<std::string> CpkArchiveDecoder::get_linked_formats() const
     return {"cri/hca", "cri/xtx", "playstation/gxt", "playstation/gtf"};
 }
 
-static auto _ = dec::register_decoder<CpkArchiveDecoder>("cri/cpk");
+static auto _ = dec::register_decoder<CpkArchiveDecoder>("cri/cpk")
+    .add_magic(magic);
@@ -47,4 +47,5 @@ res::Image CwlImageDecoder::decode_impl(
     return cwd_decoder.decode(logger, cwd_file);
 }
 
-static auto _ = dec::register_decoder<CwlImageDecoder>("crowd/cwl");
+static auto _ = dec::register_decoder<CwlImageDecoder>("crowd/cwl")
+    .add_magic(magic);
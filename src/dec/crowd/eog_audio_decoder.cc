@@ -40,4 +40,5 @@ std::unique_ptr<io::File> EogAudioDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<EogAudioDecoder>("crowd/eog");
+static auto _ = dec::register_decoder<EogAudioDecoder>("crowd/eog")
+    .add_magic(magic);
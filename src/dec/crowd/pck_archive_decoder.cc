@@ -62,8 +62,7 @@ std::unique_ptr<io::File> PckArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    return std::make_unique<io::File>(entry->path, data);
+    return open_plain_entry(input_file, *entry);
 }
 
 std::vector<std::string> PckArchiveDecoder::get_linked_formats() const
@@ -71,4 +70,5 @@ std::vector<std::string> PckArchiveDecoder::get_linked_formats() const
     return {"crowd/eog"};
 }
 
-static auto _ = dec::register_decoder<PckArchiveDecoder>("crowd/pck");
+static auto _ = dec::register_decoder<PckArchiveDecoder>("crowd/pck")
+    .add_extension("pck");
@@ -49,4 +49,5 @@ res::Image ZbmImageDecoder::decode_impl(
     return bmp_decoder.decode(logger, bmp_file);
 }
 
-static auto _ = dec::register_decoder<ZbmImageDecoder>("crowd/zbm");
+static auto _ = dec::register_decoder<ZbmImageDecoder>("crowd/zbm")
+    .add_magic(magic);
@@ -104,4 +104,5 @@ std::unique_ptr<io::File> AppendixArchiveDecoder::read_file_impl(
 }
 
 static auto _
-    = dec::register_decoder<AppendixArchiveDecoder>("cyberworks/appendix");
+    = dec::register_decoder<AppendixArchiveDecoder>("cyberworks/appendix")
+    .add_extension("appendix");
@@ -76,4 +76,5 @@ std::unique_ptr<io::File> BinArchiveDecoder::read_file_impl(
     return file;
 }
 
-static auto _ = dec::register_decoder<BinArchiveDecoder>("dogenzaka/bin");
+static auto _ = dec::register_decoder<BinArchiveDecoder>("dogenzaka/bin")
+    .add_extension("bin");
@@ -215,4 +215,5 @@ res::Image EriImageDecoder::decode_impl(
     return *base_image;
 }
 
-static auto _ = dec::register_decoder<EriImageDecoder>("entis/eri");
+static auto _ = dec::register_decoder<EriImageDecoder>("entis/eri")
+    .add_magic(magic1);
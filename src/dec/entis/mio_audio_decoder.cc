@@ -119,4 +119,5 @@ res::Audio MioAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<MioAudioDecoder>("entis/mio");
+static auto _ = dec::register_decoder<MioAudioDecoder>("entis/mio")
+    .add_magic(magic1);
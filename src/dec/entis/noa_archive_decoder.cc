@@ -201,4 +201,5 @@ std::vector<std::string> NoaArchiveDecoder::get_linked_formats() const
     return {"entis/noa", "entis/mio", "entis/eri"};
 }
 
-static auto _ = dec::register_decoder<NoaArchiveDecoder>("entis/noa");
+static auto _ = dec::register_decoder<NoaArchiveDecoder>("entis/noa")
+    .add_magic(magic1);
@@ -87,4 +87,5 @@ res::Image AcdImageDecoder::decode_impl(
     return res::Image(width, height, pixel_data, res::PixelFormat::Gray8);
 }
 
-static auto _ = dec::register_decoder<AcdImageDecoder>("fc01/acd");
+static auto _ = dec::register_decoder<AcdImageDecoder>("fc01/acd")
+    .add_magic(magic);
@@ -132,4 +132,5 @@ std::unique_ptr<io::File> McaArchiveDecoder::read_file_impl(
     return encoder.encode(logger, image, entry->path);
 }
 
-static auto _ = dec::register_decoder<McaArchiveDecoder>("fc01/mca");
+static auto _ = dec::register_decoder<McaArchiveDecoder>("fc01/mca")
+    .add_magic(magic);
@@ -85,4 +85,5 @@ res::Image NvsgImageDecoder::decode_impl(
     return res::Image(width, height, data, pixel_format);
 }
 
-static auto _ = dec::register_decoder<NvsgImageDecoder>("fvp/nvsg");
+static auto _ = dec::register_decoder<NvsgImageDecoder>("fvp/nvsg")
+    .add_magic(hzc1_magic);
@@ -128,4 +128,5 @@ std::unique_ptr<io::File> GzipArchiveDecoder::read_file_impl(
             algo::pack::ZlibKind::RawDeflate));
 }
 
-static auto _ = dec::register_decoder<GzipArchiveDecoder>("gnu/gzip");
+static auto _ = dec::register_decoder<GzipArchiveDecoder>("gnu/gzip")
+    .add_magic(magic);
@@ -102,4 +102,5 @@ res::Image GfbImageDecoder::decode_impl(
     return *image;
 }
 
-static auto _ = dec::register_decoder<GfbImageDecoder>("gpk2/gfb");
+static auto _ = dec::register_decoder<GfbImageDecoder>("gpk2/gfb")
+    .add_magic(magic);
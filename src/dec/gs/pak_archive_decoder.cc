@@ -83,4 +83,5 @@ std::vector<std::string> PakArchiveDecoder::get_linked_formats() const
     return {"gs/gfx"};
 }
 
-static auto _ = dec::register_decoder<PakArchiveDecoder>("gs/pak");
+static auto _ = dec::register_decoder<PakArchiveDecoder>("gs/pak")
+    .add_magic(magic);
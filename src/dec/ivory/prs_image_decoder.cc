@@ -142,4 +142,5 @@ res::Image PrsImageDecoder::decode_impl(
     return res::Image(width, height, target, res::PixelFormat::BGR888);
 }
 
-static auto _ = dec::register_decoder<PrsImageDecoder>("ivory/prs");
+static auto _ = dec::register_decoder<PrsImageDecoder>("ivory/prs")
+    .add_magic(magic);
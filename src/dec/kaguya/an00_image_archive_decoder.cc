@@ -87,4 +87,5 @@ std::unique_ptr<io::File> An00ImageArchiveDecoder::read_file_impl(
     return enc::png::PngImageEncoder().encode(logger, image, entry->path);
 }
 
-static auto _ = dec::register_decoder<An00ImageArchiveDecoder>("kaguya/an00");
+static auto _ = dec::register_decoder<An00ImageArchiveDecoder>("kaguya/an00")
+    .add_magic(magic);
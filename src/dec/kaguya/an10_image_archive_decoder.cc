@@ -91,4 +91,5 @@ std::unique_ptr<io::File> An10ImageArchiveDecoder::read_file_impl(
     return enc::png::PngImageEncoder().encode(logger, image, entry->path);
 }
 
-static auto _ = dec::register_decoder<An10ImageArchiveDecoder>("kaguya/an10");
+static auto _ = dec::register_decoder<An10ImageArchiveDecoder>("kaguya/an10")
+    .add_magic(magic);
@@ -107,4 +107,5 @@ std::unique_ptr<io::File> An20ImageArchiveDecoder::read_file_impl(
     return enc::png::PngImageEncoder().encode(logger, image, entry->path);
 }
 
-static auto _ = dec::register_decoder<An20ImageArchiveDecoder>("kaguya/an20");
+static auto _ = dec::register_decoder<An20ImageArchiveDecoder>("kaguya/an20")
+    .add_magic(magic);
@@ -42,4 +42,5 @@ res::Image Ap0ImageDecoder::decode_impl(
         .flip_vertically();
 }
 
-static auto _ = dec::register_decoder<Ap0ImageDecoder>("kaguya/ap0");
+static auto _ = dec::register_decoder<Ap0ImageDecoder>("kaguya/ap0")
+    .add_magic(magic);
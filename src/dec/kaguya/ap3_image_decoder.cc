@@ -44,4 +44,5 @@ res::Image Ap3ImageDecoder::decode_impl(
         .flip_vertically();
 }
 
-static auto _ = dec::register_decoder<Ap3ImageDecoder>("kaguya/ap3");
+static auto _ = dec::register_decoder<Ap3ImageDecoder>("kaguya/ap3")
+    .add_magic(magic);
@@ -43,4 +43,5 @@ res::Image ApImageDecoder::decode_impl(
         .flip_vertically();
 }
 
-static auto _ = dec::register_decoder<ApImageDecoder>("kaguya/ap");
+static auto _ = dec::register_decoder<ApImageDecoder>("kaguya/ap")
+    .add_magic(magic);
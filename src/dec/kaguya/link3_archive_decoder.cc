@@ -32,4 +32,5 @@ int Link3ArchiveDecoder::get_version() const
     return 3;
 }
 
-static auto _ = dec::register_decoder<Link3ArchiveDecoder>("kaguya/link3");
+static auto _ = dec::register_decoder<Link3ArchiveDecoder>("kaguya/link3")
+    .add_magic(magic);
@@ -94,4 +94,5 @@ std::vector<std::string> LinkArchiveDecoder::get_linked_formats() const
     return {"microsoft/bmp"};
 }
 
-static auto _ = dec::register_decoder<LinkArchiveDecoder>("kaguya/link");
+static auto _ = dec::register_decoder<LinkArchiveDecoder>("kaguya/link")
+    .add_magic(magic);
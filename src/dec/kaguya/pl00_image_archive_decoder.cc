@@ -95,4 +95,5 @@ std::unique_ptr<io::File> Pl00ImageArchiveDecoder::read_file_impl(
     return enc::png::PngImageEncoder().encode(logger, image, entry->path);
 }
 
-static auto _ = dec::register_decoder<Pl00ImageArchiveDecoder>("kaguya/pl00");
+static auto _ = dec::register_decoder<Pl00ImageArchiveDecoder>("kaguya/pl00")
+    .add_magic(magic);
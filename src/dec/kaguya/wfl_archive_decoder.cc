@@ -97,4 +97,5 @@ std::vector<std::string> WflArchiveDecoder::get_linked_formats() const
     return {"kaguya/ap", "kaguya/ao", "kaguya/aps3", "microsoft/bmp"};
 }
 
-static auto _ = dec::register_decoder<WflArchiveDecoder>("kaguya/wfl");
+static auto _ = dec::register_decoder<WflArchiveDecoder>("kaguya/wfl")
+    .add_magic(magic);
@@ -104,4 +104,5 @@ res::Image PrtImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<PrtImageDecoder>("kid/prt");
+static auto _ = dec::register_decoder<PrtImageDecoder>("kid/prt")
+    .add_magic(magic);
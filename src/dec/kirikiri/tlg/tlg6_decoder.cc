@@ -16,10 +16,20 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/tlg/tlg6_decoder.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include "algo/idle_helpers.h"
 #include "algo/range.h"
 #include "dec/kirikiri/tlg/lzss_decompressor.h"
 #include "err.h"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TLG6_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
 using namespace au;
 using namespace au::dec::kirikiri::tlg;
 
@@ -29,6 +39,12 @@ static const int golomb_n_count = 4;
 static const int leading_zero_table_bits = 12;
 static const int leading_zero_table_size = (1 << leading_zero_table_bits);
 
+// Images with fewer pixels are not worth sharing with other threads.
+static const size_t min_parallel_pixel_count = 256 * 1024;
+
+// Block rows decoded ahead of the caller are bounded to keep memory in check.
+static const size_t max_block_rows_ahead = 32;
+
 static u8 leading_zero_table[leading_zero_table_size];
 static u8 golomb_bit_size_table[golomb_n_count * 2 * 128][golomb_n_count];
 
@@ -54,6 +70,46 @@ namespace
 
         bstr data;
     };
+
+    // Bit pools of each channel of each block row are independent, so for
+    // large images idle pool threads Golomb-decode them in stream order,
+    // staying a bounded number of block rows ahead of the caller, who
+    // filters the block rows as soon as they are ready. Smaller images are
+    // decoded a block row at a time into a single buffer.
+    class GolombPass final
+    {
+    public:
+        GolombPass(io::BaseByteStream &input_stream, const Header &header);
+        ~GolombPass();
+
+        // Block rows must be requested in order, each released before the
+        // next one is requested. Blocks until all channels of the row are
+        // decoded, helping with the decoding in the meantime.
+        u32 *get_block_row(const size_t block_y);
+        void release_block_row(const size_t block_y);
+
+    private:
+        size_t get_block_row_size(const size_t block_y) const;
+        bool run_next_job(const bool wait_for_room);
+
+        const Header &header;
+        io::BaseByteStream &input_stream;
+        const bool parallel;
+
+        // serial decoding
+        bstr block_row;
+
+        // parallel decoding
+        std::vector<bstr> bit_pools;
+        std::vector<bstr> block_rows;
+        std::vector<size_t> pending_channels;
+        size_t next_job;
+        size_t released_block_rows;
+        std::mutex mutex;
+        std::condition_variable job_done;
+        std::condition_variable block_row_released;
+        std::unique_ptr<algo::HelpRequest> help_request;
+    };
 }
 
 FilterTypes::FilterTypes(io::BaseByteStream &input_stream)
@@ -84,114 +140,6 @@ void FilterTypes::decompress(const Header &header)
     data = decompressor.decompress(data, output_size);
 }
 
-static inline u32 to_bgra(res::Pixel p)
-{
-    return p.b | (p.g << 8) | (p.r << 16) | (p.a << 24);
-}
-
-static void transformer0(res::Pixel &)
-{
-}
-
-static void transformer1(res::Pixel &p)
-{
-    p.r += p.g;
-    p.b += p.g;
-}
-
-static void transformer2(res::Pixel &p)
-{
-    p.g += p.b;
-    p.r += p.g;
-}
-
-static void transformer3(res::Pixel &p)
-{
-    p.g += p.r;
-    p.b += p.g;
-}
-
-static void transformer4(res::Pixel &p)
-{
-    p.b += p.r;
-    p.g += p.b;
-    p.r += p.g;
-}
-
-static void transformer5(res::Pixel &p)
-{
-    p.b += p.r;
-    p.g += p.b;
-}
-
-static void transformer6(res::Pixel &p)
-{
-    p.b += p.g;
-}
-
-static void transformer7(res::Pixel &p)
-{
-    p.g += p.b;
-}
-
-static void transformer8(res::Pixel &p)
-{
-    p.r += p.g;
-}
-
-static void transformer9(res::Pixel &p)
-{
-    p.r += p.b;
-    p.g += p.r;
-    p.b += p.g;
-}
-
-static void transformerA(res::Pixel &p)
-{
-    p.b += p.r;
-    p.g += p.r;
-}
-
-static void transformerB(res::Pixel &p)
-{
-    p.r += p.b;
-    p.g += p.b;
-}
-
-static void transformerC(res::Pixel &p)
-{
-    p.r += p.b;
-    p.g += p.r;
-}
-
-static void transformerD(res::Pixel &p)
-{
-    p.b += p.g;
-    p.r += p.b;
-    p.g += p.r;
-}
-
-static void transformerE(res::Pixel &p)
-{
-    p.g += p.r;
-    p.b += p.g;
-    p.r += p.b;
-}
-
-static void transformerF(res::Pixel &p)
-{
-    p.g += (p.b << 1);
-    p.r += (p.b << 1);
-}
-
-static void (*transformers[16])(res::Pixel &p) =
-{
-    &transformer0, &transformer1, &transformer2, &transformer3,
-    &transformer4, &transformer5, &transformer6, &transformer7,
-    &transformer8, &transformer9, &transformerA, &transformerB,
-    &transformerC, &transformerD, &transformerE, &transformerF,
-};
-
 static inline u32 make_gt_mask(u32 a, u32 b)
 {
     u32 tmp2 = ~b;
@@ -224,13 +172,157 @@ static inline u32 avg(u32 a, u32 b, u32, u32 v)
         + ((a ^ b) & 0x01010101), v);
 }
 
-static void init_table()
+// Pixels are handled as packed BGRA words, as laid out by res::Pixel.
+static_assert(sizeof(res::Pixel) == 4, "Pixels must be packed");
+static const int b_shift = 0;
+static const int g_shift = 8;
+static const int r_shift = 16;
+
+// Adds one channel to another, without carrying into the other channels.
+template<int to, int from> static inline u32 add_channel(const u32 p)
+{
+    const u32 source = to >= from
+        ? p << ((to - from) & 31)
+        : p >> ((from - to) & 31);
+    return packed_bytes_add(p, source & (0xFFu << to));
+}
+
+#ifdef TLG6_USE_SSE2
+template<int to, int from> static inline __m128i add_channel(const __m128i p)
 {
-    static bool initialized = false;
-    if (initialized)
+    const auto source = to >= from
+        ? _mm_slli_epi32(p, (to - from) & 31)
+        : _mm_srli_epi32(p, (from - to) & 31);
+    return _mm_add_epi8(p, _mm_and_si128(source, _mm_set1_epi32(0xFF << to)));
+}
+#endif
+
+// Undoes one of the 16 color decorrelations; works on a single packed pixel
+// as well as on a vector of them.
+template<int type, typename T> static inline T transform(T p)
+{
+    switch (type)
+    {
+        case 0x1:
+            p = add_channel<r_shift, g_shift>(p);
+            p = add_channel<b_shift, g_shift>(p);
+            break;
+        case 0x2:
+            p = add_channel<g_shift, b_shift>(p);
+            p = add_channel<r_shift, g_shift>(p);
+            break;
+        case 0x3:
+            p = add_channel<g_shift, r_shift>(p);
+            p = add_channel<b_shift, g_shift>(p);
+            break;
+        case 0x4:
+            p = add_channel<b_shift, r_shift>(p);
+            p = add_channel<g_shift, b_shift>(p);
+            p = add_channel<r_shift, g_shift>(p);
+            break;
+        case 0x5:
+            p = add_channel<b_shift, r_shift>(p);
+            p = add_channel<g_shift, b_shift>(p);
+            break;
+        case 0x6:
+            p = add_channel<b_shift, g_shift>(p);
+            break;
+        case 0x7:
+            p = add_channel<g_shift, b_shift>(p);
+            break;
+        case 0x8:
+            p = add_channel<r_shift, g_shift>(p);
+            break;
+        case 0x9:
+            p = add_channel<r_shift, b_shift>(p);
+            p = add_channel<g_shift, r_shift>(p);
+            p = add_channel<b_shift, g_shift>(p);
+            break;
+        case 0xA:
+            p = add_channel<b_shift, r_shift>(p);
+            p = add_channel<g_shift, r_shift>(p);
+            break;
+        case 0xB:
+            p = add_channel<r_shift, b_shift>(p);
+            p = add_channel<g_shift, b_shift>(p);
+            break;
+        case 0xC:
+            p = add_channel<r_shift, b_shift>(p);
+            p = add_channel<g_shift, r_shift>(p);
+            break;
+        case 0xD:
+            p = add_channel<b_shift, g_shift>(p);
+            p = add_channel<r_shift, b_shift>(p);
+            p = add_channel<g_shift, r_shift>(p);
+            break;
+        case 0xE:
+            p = add_channel<g_shift, r_shift>(p);
+            p = add_channel<b_shift, g_shift>(p);
+            p = add_channel<r_shift, b_shift>(p);
+            break;
+        case 0xF:
+            // g += b * 2, r += b * 2
+            p = add_channel<g_shift, b_shift>(p);
+            p = add_channel<g_shift, b_shift>(p);
+            p = add_channel<r_shift, b_shift>(p);
+            p = add_channel<r_shift, b_shift>(p);
+            break;
+    }
+    return p;
+}
+
+// The transformation doesn't depend on the neighboring pixels, so it is
+// applied to whole blocks ahead of the filtering.
+template<int type> static void transform_pixels(u32 *pixels, size_t count)
+{
+    if (!type)
         return;
-    initialized = true;
+#ifdef TLG6_USE_SSE2
+    for (; count >= 4; count -= 4, pixels += 4)
+    {
+        const auto ptr = reinterpret_cast<__m128i*>(pixels);
+        _mm_storeu_si128(ptr, transform<type>(_mm_loadu_si128(ptr)));
+    }
+#endif
+    for (; count; count--, pixels++)
+        *pixels = transform<type>(*pixels);
+}
+
+static void (*const pixel_transformers[16])(u32 *, size_t) =
+{
+    &transform_pixels<0x0>, &transform_pixels<0x1>,
+    &transform_pixels<0x2>, &transform_pixels<0x3>,
+    &transform_pixels<0x4>, &transform_pixels<0x5>,
+    &transform_pixels<0x6>, &transform_pixels<0x7>,
+    &transform_pixels<0x8>, &transform_pixels<0x9>,
+    &transform_pixels<0xA>, &transform_pixels<0xB>,
+    &transform_pixels<0xC>, &transform_pixels<0xD>,
+    &transform_pixels<0xE>, &transform_pixels<0xF>,
+};
 
+template<u32 (*filter)(u32, u32, u32, u32)> static inline void filter_pixels(
+    const u32 *&in,
+    u32 *&current_line,
+    const u32 *&prev_line,
+    u32 &left,
+    u32 &top_left,
+    int w,
+    const int step,
+    const u32 alpha_mask)
+{
+    do
+    {
+        const auto top = *prev_line++;
+        left = filter(left, top, top_left, *in) | alpha_mask;
+        top_left = top;
+        *current_line++ = left;
+        in += step;
+    }
+    while (--w);
+}
+
+static void init_table()
+{
     short golomb_compression_table[golomb_n_count][9] =
     {
         {3, 7, 15, 27, 63, 108, 223, 448, 130},
@@ -387,18 +479,19 @@ static void decode_golomb_values(u8 *pixel_buf, int pixel_count, u8 *bit_pool)
 }
 
 static void decode_line(
-    res::Pixel *prev_line,
-    res::Pixel *current_line,
+    const u32 *prev_line,
+    u32 *current_line,
     int start_block,
     int block_limit,
     u8 *filter_types,
     int skip_block_bytes,
-    u32 *in,
+    const u32 *in,
     int odd_skip,
     int dir,
     const Header &header)
 {
-    res::Pixel left, top_left;
+    const u32 alpha_mask = header.channel_count == 3 ? 0xFF000000 : 0;
+    u32 left, top_left;
     int step;
 
     if (start_block)
@@ -410,9 +503,7 @@ static void decode_line(
     }
     else
     {
-        left.r = left.g = left.b = 0;
-        top_left.r = top_left.g = top_left.b = 0;
-        left.a = top_left.a = header.channel_count == 3 ? 0xFF : 0;
+        left = top_left = alpha_mask;
     }
 
     in += skip_block_bytes * start_block;
@@ -431,38 +522,18 @@ static void decode_line(
         if (i & 1)
             in += odd_skip * ww;
 
-        auto filter = filter_types[i] & 1 ? &avg : &med;
-        auto transformer = transformers[filter_types[i] >> 1];
-
-        do
+        if (filter_types[i] & 1)
+        {
+            filter_pixels<avg>(
+                in, current_line, prev_line, left, top_left,
+                w, step, alpha_mask);
+        }
+        else
         {
-            res::Pixel inn;
-            inn.a = *in >> 24;
-            inn.r = *in >> 16;
-            inn.g = *in >> 8;
-            inn.b = *in;
-            transformer(inn);
-
-            res::Pixel top = *prev_line;
-            auto result = filter(
-                to_bgra(left),
-                to_bgra(top),
-                to_bgra(top_left),
-                to_bgra(inn));
-            left.a = result >> 24;
-            left.r = result >> 16;
-            left.g = result >> 8;
-            left.b = result;
-            if (header.channel_count == 3)
-                left.a = 0xFF;
-
-            top_left = top;
-            *current_line++ = left;
-
-            prev_line++;
-            in += step;
+            filter_pixels<med>(
+                in, current_line, prev_line, left, top_left,
+                w, step, alpha_mask);
         }
-        while (--w);
 
         in += skip_block_bytes + (step == 1 ? - ww : 1);
         if (i & 1)
@@ -470,15 +541,168 @@ static void decode_line(
     }
 }
 
+static bstr read_bit_pool(io::BaseByteStream &input_stream)
+{
+    u32 bit_size = input_stream.read_le<u32>();
+
+    int method = (bit_size >> 30) & 3;
+    bit_size &= 0x3FFFFFFF;
+    if (method != 0)
+        throw err::NotSupportedError("Unsupported encoding method");
+
+    int byte_size = (bit_size + 7) / 8;
+    auto bit_pool = input_stream.read(byte_size);
+
+    // Although decode_golomb_values accesses only valid bits, it uses
+    // reinterpret_cast<u32*>() that might access bits out of bounds.
+    // This is to make sure those calls don't cause access violation.
+    bit_pool.resize(byte_size + 4);
+    return bit_pool;
+}
+
+GolombPass::GolombPass(
+    io::BaseByteStream &input_stream, const Header &header) :
+        header(header),
+        input_stream(input_stream),
+        parallel(header.image_width * header.image_height
+            >= min_parallel_pixel_count),
+        next_job(0),
+        released_block_rows(0)
+{
+    if (!parallel)
+    {
+        block_row = bstr(4 * header.image_width * h_block_size);
+        return;
+    }
+
+    // helpers can't share the input stream, so the bit pools are read
+    // up front; the block rows they decode into are made as needed
+    bit_pools.resize(header.y_block_count * header.channel_count);
+    for (auto &bit_pool : bit_pools)
+        bit_pool = read_bit_pool(input_stream);
+    block_rows.resize(header.y_block_count);
+    pending_channels.resize(header.y_block_count, header.channel_count);
+
+    help_request = std::make_unique<algo::HelpRequest>(
+        [this]()
+        {
+            while (run_next_job(true))
+            {
+            }
+        },
+        bit_pools.size());
+}
+
+GolombPass::~GolombPass()
+{
+    // let the helpers run out of jobs rather than leave them dangling
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        next_job = bit_pools.size();
+    }
+    block_row_released.notify_all();
+    help_request.reset();
+}
+
+size_t GolombPass::get_block_row_size(const size_t block_y) const
+{
+    const auto y = block_y * h_block_size;
+    const auto line_count = std::min<size_t>(
+        h_block_size, header.image_height - y);
+    return 4 * header.image_width * line_count;
+}
+
+bool GolombPass::run_next_job(const bool wait_for_room)
+{
+    size_t job;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto has_room = [&]()
+        {
+            return next_job >= bit_pools.size()
+                || next_job / header.channel_count
+                    < released_block_rows + max_block_rows_ahead;
+        };
+        if (wait_for_room)
+            block_row_released.wait(lock, has_room);
+        else if (!has_room())
+            return false;
+        if (next_job >= bit_pools.size())
+            return false;
+        job = next_job++;
+        // channels are handed out in order, so the first one makes the row
+        if (job % header.channel_count == 0)
+        {
+            const auto block_y = job / header.channel_count;
+            block_rows[block_y] = bstr(get_block_row_size(block_y));
+        }
+    }
+
+    const auto block_y = job / header.channel_count;
+    const auto c = job % header.channel_count;
+    const auto pixel_count = block_rows[block_y].size() / 4;
+    decode_golomb_values(
+        block_rows[block_y].get<u8>() + c,
+        pixel_count,
+        bit_pools[job].get<u8>());
+    bit_pools[job] = bstr();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_channels[block_y]--;
+    job_done.notify_all();
+    return true;
+}
+
+u32 *GolombPass::get_block_row(const size_t block_y)
+{
+    if (!parallel)
+    {
+        const auto pixel_count = get_block_row_size(block_y) / 4;
+        for (const auto c : algo::range(header.channel_count))
+        {
+            auto bit_pool = read_bit_pool(input_stream);
+            decode_golomb_values(
+                block_row.get<u8>() + c, pixel_count, bit_pool.get<u8>());
+        }
+        return block_row.get<u32>();
+    }
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!pending_channels[block_y])
+                return block_rows[block_y].get<u32>();
+        }
+        if (!run_next_job(false))
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job_done.wait(lock, [&]() { return !pending_channels[block_y]; });
+        }
+    }
+}
+
+void GolombPass::release_block_row(const size_t block_y)
+{
+    if (!parallel)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        block_rows[block_y] = bstr();
+        released_block_rows = block_y + 1;
+    }
+    block_row_released.notify_all();
+}
+
 static void read_image(
     io::BaseByteStream &input_stream, res::Image &image, const Header &header)
 {
     FilterTypes filter_types(input_stream);
     filter_types.decompress(header);
 
-    bstr pixel_buf(4 * header.image_width * h_block_size);
-    auto zero_line = std::make_unique<res::Pixel[]>(header.image_width);
-    res::Pixel *prev_line = zero_line.get();
+    GolombPass golomb_pass(input_stream, header);
+    auto zero_line = std::make_unique<u32[]>(header.image_width);
+    const u32 *prev_line = zero_line.get();
 
     u32 main_count = header.image_width / w_block_size;
     for (const auto y : algo::range(0, header.image_height, h_block_size))
@@ -487,36 +711,24 @@ static void read_image(
         if (ylim >= header.image_height)
             ylim = header.image_height;
 
-        int pixel_count = (ylim - y) * header.image_width;
-        for (const auto c : algo::range(header.channel_count))
-        {
-            u32 bit_size = input_stream.read_le<u32>();
+        const auto block_y = y / h_block_size;
+        const auto pixel_buf = golomb_pass.get_block_row(block_y);
 
-            int method = (bit_size >> 30) & 3;
-            bit_size &= 0x3FFFFFFF;
-
-            int byte_size = (bit_size + 7) / 8;
-            bstr bit_pool = input_stream.read(byte_size);
-
-            // Although decode_golomb_values accesses only valid bits, it uses
-            // reinterpret_cast<u32*>() that might access bits out of bounds.
-            // This is to make sure those calls don't cause access violation.
-            bit_pool.resize(byte_size + 4);
-
-            if (method != 0)
-                throw err::NotSupportedError("Unsupported encoding method");
+        u8 *ft = filter_types.data.get<u8>() + block_y * header.x_block_count;
+        int skip_bytes = (ylim - y) * w_block_size;
 
-            decode_golomb_values(
-                pixel_buf.get<u8>() + c, pixel_count, bit_pool.get<u8>());
+        // each block occupies a contiguous run of the block row buffer
+        for (const auto block_x : algo::range(header.x_block_count))
+        {
+            const auto block_width = std::min<size_t>(
+                w_block_size, header.image_width - block_x * w_block_size);
+            pixel_transformers[ft[block_x] >> 1](
+                pixel_buf + block_x * skip_bytes, (ylim - y) * block_width);
         }
 
-        u8 *ft = filter_types.data.get<u8>()
-            + (y / h_block_size) * header.x_block_count;
-        int skip_bytes = (ylim - y) * w_block_size;
-
         for (const auto yy : algo::range(y, ylim))
         {
-            auto *current_line = &image.at(0, yy);
+            auto *current_line = reinterpret_cast<u32*>(&image.at(0, yy));
 
             int dir = (yy & 1) ^ 1;
             int odd_skip = ((ylim - yy -1) - (yy - y));
@@ -534,7 +746,7 @@ static void read_image(
                     main_count,
                     ft,
                     skip_bytes,
-                    pixel_buf.get<u32>() + start,
+                    pixel_buf + start,
                     odd_skip,
                     dir,
                     header);
@@ -554,7 +766,7 @@ static void read_image(
                     header.x_block_count,
                     ft,
                     skip_bytes,
-                    pixel_buf.get<u32>() + start,
+                    pixel_buf + start,
                     odd_skip,
                     dir,
                     header);
@@ -562,12 +774,15 @@ static void read_image(
 
             prev_line = current_line;
         }
+
+        golomb_pass.release_block_row(block_y);
     }
 }
 
 res::Image Tlg6Decoder::decode(io::File &file)
 {
-    init_table();
+    static std::once_flag table_initialized;
+    std::call_once(table_initialized, init_table);
 
     Header header;
     header.channel_count = file.stream.read<u8>();
@@ -16,11 +16,14 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include <limits>
 #include "algo/locale.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
+#include "io/segmented_byte_stream.h"
+#include "io/slice_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::kirikiri;
@@ -76,6 +79,9 @@ static const bstr segm_chunk_magic = "segm"_b;
 static const bstr adlr_chunk_magic = "adlr"_b;
 static const bstr time_chunk_magic = "time"_b;
 
+// deflate can't expand data by more than this factor
+static const uoff_t max_zlib_ratio = 1032;
+
 static int detect_version(io::BaseByteStream &input_stream)
 {
     if (input_stream.seek(19).read_le<u32>() == 1)
@@ -270,15 +276,84 @@ std::unique_ptr<io::File> Xp3ArchiveDecoder::read_file_impl(
     const auto meta = static_cast<const CustomArchiveMeta*>(&m);
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
 
+    // entries stored verbatim are read on demand when saved
+    bool is_plain = !meta->decrypt_func;
+    for (const auto &segm_chunk : entry->segm_chunks)
+        is_plain &= !(segm_chunk->flags & 7);
+    if (is_plain)
+    {
+        const auto input_size = input_file.stream.size();
+        const std::shared_ptr<io::BaseByteStream> input_stream
+            = input_file.stream.clone();
+        auto output_stream = std::make_unique<io::SegmentedByteStream>();
+        for (const auto &segm_chunk : entry->segm_chunks)
+        {
+            const auto offset = segm_chunk->offset;
+            const auto size = segm_chunk->size_orig;
+            if (offset > input_size || size > input_size - offset)
+                throw err::EofError();
+            output_stream->add_segment(
+                size,
+                [input_stream, offset, size]()
+                {
+                    return std::make_unique<io::SliceByteStream>(
+                        *input_stream, offset, size);
+                });
+        }
+        return std::make_unique<io::File>(
+            entry->path, std::move(output_stream));
+    }
+
+    // the index decides how much gets allocated, so it's checked against the
+    // input before anything is read
+    const auto input_size = input_file.stream.size();
+    uoff_t total_size = 0;
+    for (const auto &segm_chunk : entry->segm_chunks)
+    {
+        const auto data_is_compressed = segm_chunk->flags & 7;
+        const auto offset = segm_chunk->offset;
+        const auto stored_size = data_is_compressed
+            ? segm_chunk->size_comp
+            : segm_chunk->size_orig;
+        if (offset > input_size || stored_size > input_size - offset)
+            throw err::EofError();
+        if (data_is_compressed
+            && segm_chunk->size_orig / max_zlib_ratio > segm_chunk->size_comp)
+        {
+            throw err::BadDataSizeError();
+        }
+        if (segm_chunk->size_orig
+            > std::numeric_limits<uoff_t>::max() - total_size)
+        {
+            throw err::BadDataSizeError();
+        }
+        total_size += segm_chunk->size_orig;
+    }
+    if (total_size != entry->info_chunk->file_size_orig
+        || total_size > std::numeric_limits<size_t>::max())
+    {
+        throw err::BadDataSizeError();
+    }
+
     bstr data;
+    data.resize_uninitialized(total_size);
+    auto data_ptr = data.get<u8>();
     for (const auto &segm_chunk : entry->segm_chunks)
     {
         const auto data_is_compressed = segm_chunk->flags & 7;
-        input_file.stream.seek(segm_chunk->offset);
-        data += data_is_compressed
-            ? algo::pack::zlib_inflate(
-                input_file.stream.read(segm_chunk->size_comp))
-            : input_file.stream.read(segm_chunk->size_orig);
+        if (data_is_compressed)
+        {
+            io::SliceByteStream segm_stream(
+                input_file.stream, segm_chunk->offset, segm_chunk->size_comp);
+            algo::pack::zlib_inflate(
+                segm_stream, data_ptr, segm_chunk->size_orig);
+        }
+        else
+        {
+            input_file.stream.read_at(
+                segm_chunk->offset, data_ptr, segm_chunk->size_orig);
+        }
+        data_ptr += segm_chunk->size_orig;
     }
 
     if (meta->decrypt_func)
@@ -292,4 +367,5 @@ std::vector<std::string> Xp3ArchiveDecoder::get_linked_formats() const
     return {"kirikiri/tlg"};
 }
 
-static auto _ = dec::register_decoder<Xp3ArchiveDecoder>("kirikiri/xp3");
+static auto _ = dec::register_decoder<Xp3ArchiveDecoder>("kirikiri/xp3")
+    .add_magic(xp3_magic);
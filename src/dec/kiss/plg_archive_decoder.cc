@@ -68,4 +68,5 @@ std::vector<std::string> PlgArchiveDecoder::get_linked_formats() const
     return {"kiss/plg", "kiss/custom-png"};
 }
 
-static auto _ = dec::register_decoder<PlgArchiveDecoder>("kiss/plg");
+static auto _ = dec::register_decoder<PlgArchiveDecoder>("kiss/plg")
+    .add_magic(magic);
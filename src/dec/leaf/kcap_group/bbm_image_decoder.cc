@@ -63,4 +63,5 @@ res::Image BbmImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<BbmImageDecoder>("leaf/bbm");
+static auto _ = dec::register_decoder<BbmImageDecoder>("leaf/bbm")
+    .add_extension("bbm");
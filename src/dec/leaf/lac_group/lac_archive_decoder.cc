@@ -60,4 +60,5 @@ std::unique_ptr<io::File> LacArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<LacArchiveDecoder>("leaf/lac");
+static auto _ = dec::register_decoder<LacArchiveDecoder>("leaf/lac")
+    .add_magic(magic);
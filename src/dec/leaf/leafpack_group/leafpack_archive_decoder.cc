@@ -117,4 +117,5 @@ std::vector<std::string> LeafpackArchiveDecoder::get_linked_formats() const
     };
 }
 
-static auto _ = dec::register_decoder<LeafpackArchiveDecoder>("leaf/leafpack");
+static auto _ = dec::register_decoder<LeafpackArchiveDecoder>("leaf/leafpack")
+    .add_magic(magic);
@@ -49,4 +49,5 @@ res::Image Lf2ImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<Lf2ImageDecoder>("leaf/lf2");
+static auto _ = dec::register_decoder<Lf2ImageDecoder>("leaf/lf2")
+    .add_magic(magic);
@@ -46,4 +46,5 @@ res::Image Lf3ImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<Lf3ImageDecoder>("leaf/lf3");
+static auto _ = dec::register_decoder<Lf3ImageDecoder>("leaf/lf3")
+    .add_magic(magic);
@@ -38,4 +38,5 @@ res::Image LfbImageDecoder::decode_impl(
     return dec::microsoft::BmpImageDecoder().decode(logger, *pseudo_file);
 }
 
-static auto _ = dec::register_decoder<LfbImageDecoder>("leaf/lfb");
+static auto _ = dec::register_decoder<LfbImageDecoder>("leaf/lfb")
+    .add_extension("lfb");
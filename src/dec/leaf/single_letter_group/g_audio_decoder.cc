@@ -134,4 +134,5 @@ std::unique_ptr<io::File> GAudioDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<GAudioDecoder>("leaf/g");
+static auto _ = dec::register_decoder<GAudioDecoder>("leaf/g")
+    .add_extension("g");
@@ -509,4 +509,5 @@ algo::NamingStrategy PxImageArchiveDecoder::naming_strategy() const
     return algo::NamingStrategy::Sibling;
 }
 
-static auto _ = dec::register_decoder<PxImageArchiveDecoder>("leaf/px");
+static auto _ = dec::register_decoder<PxImageArchiveDecoder>("leaf/px")
+    .add_extension("px");
@@ -49,4 +49,5 @@ res::Audio WAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<WAudioDecoder>("leaf/w");
+static auto _ = dec::register_decoder<WAudioDecoder>("leaf/w")
+    .add_extension("w");
@@ -71,4 +71,5 @@ res::Image LimImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<LimImageDecoder>("liar-soft/lim");
+static auto _ = dec::register_decoder<LimImageDecoder>("liar-soft/lim")
+    .add_magic(magic);
@@ -64,4 +64,5 @@ res::Image WcgImageDecoder::decode_impl(
     return res::Image(width, height, output, res::PixelFormat::BGRA8888);
 }
 
-static auto _ = dec::register_decoder<WcgImageDecoder>("liar-soft/wcg");
+static auto _ = dec::register_decoder<WcgImageDecoder>("liar-soft/wcg")
+    .add_magic(magic);
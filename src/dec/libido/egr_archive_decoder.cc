@@ -87,4 +87,5 @@ std::unique_ptr<io::File> EgrArchiveDecoder::read_file_impl(
     return encoder.encode(logger, image, entry->path);
 }
 
-static auto _ = dec::register_decoder<EgrArchiveDecoder>("libido/egr");
+static auto _ = dec::register_decoder<EgrArchiveDecoder>("libido/egr")
+    .add_extension("egr");
@@ -150,4 +150,5 @@ res::Image AbmImageDecoder::decode_impl(
         throw err::UnsupportedBitDepthError(depth);
 }
 
-static auto _ = dec::register_decoder<AbmImageDecoder>("lilim/abm");
+static auto _ = dec::register_decoder<AbmImageDecoder>("lilim/abm")
+    .add_extension("abm");
@@ -73,4 +73,5 @@ std::vector<std::string> Aos1ArchiveDecoder::get_linked_formats() const
     return {"lilim/scr", "lilim/abm", "microsoft/bmp"};
 }
 
-static auto _ = dec::register_decoder<Aos1ArchiveDecoder>("lilim/aos1");
+static auto _ = dec::register_decoder<Aos1ArchiveDecoder>("lilim/aos1")
+    .add_extension("aos");
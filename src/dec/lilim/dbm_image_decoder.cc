@@ -69,4 +69,5 @@ res::Image DbmImageDecoder::decode_impl(
         algo::format("Pixel format %d is not supported", format));
 }
 
-static auto _ = dec::register_decoder<DbmImageDecoder>("lilim/dbm");
+static auto _ = dec::register_decoder<DbmImageDecoder>("lilim/dbm")
+    .add_magic(magic);
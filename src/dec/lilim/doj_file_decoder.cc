@@ -49,4 +49,5 @@ std::unique_ptr<io::File> DojFileDecoder::decode_impl(
     return std::make_unique<io::File>(input_file.path, data);
 }
 
-static auto _ = dec::register_decoder<DojFileDecoder>("lilim/doj");
+static auto _ = dec::register_decoder<DojFileDecoder>("lilim/doj")
+    .add_extension("doj");
@@ -69,4 +69,5 @@ std::vector<std::string> DpkArchiveDecoder::get_linked_formats() const
     return {"lilim/dbm", "lilim/doj", "lilim/dwv"};
 }
 
-static auto _ = dec::register_decoder<DpkArchiveDecoder>("lilim/dpk");
+static auto _ = dec::register_decoder<DpkArchiveDecoder>("lilim/dpk")
+    .add_magic(magic);
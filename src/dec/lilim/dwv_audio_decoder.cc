@@ -57,4 +57,5 @@ res::Audio DwvAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<DwvAudioDecoder>("lilim/dwv");
+static auto _ = dec::register_decoder<DwvAudioDecoder>("lilim/dwv")
+    .add_extension("dwv");
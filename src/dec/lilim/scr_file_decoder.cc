@@ -70,4 +70,5 @@ std::unique_ptr<io::File> ScrFileDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<ScrFileDecoder>("lilim/scr");
+static auto _ = dec::register_decoder<ScrFileDecoder>("lilim/scr")
+    .add_extension("scr");
@@ -330,4 +330,5 @@ res::Image ElgImageDecoder::decode_impl(
     }
 }
 
-static auto _ = dec::register_decoder<ElgImageDecoder>("lucifen/elg");
+static auto _ = dec::register_decoder<ElgImageDecoder>("lucifen/elg")
+    .add_magic(magic);
@@ -74,4 +74,5 @@ std::vector<std::string> MpkArchiveDecoder::get_linked_formats() const
     return {"microsoft/dds", "png/png"};
 }
 
-static auto _ = dec::register_decoder<MpkArchiveDecoder>("mages/mpk");
+static auto _ = dec::register_decoder<MpkArchiveDecoder>("mages/mpk")
+    .add_magic(magic);
@@ -54,24 +54,30 @@ void CamelliaStream::seek_impl(const uoff_t offset)
 
 void CamelliaStream::read_impl(void *destination, const size_t size)
 {
+    const auto old_pos = pos();
+    read_at_impl(old_pos, destination, size);
+    seek(old_pos + size);
+}
+
+void CamelliaStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
+{
+    const auto parent_pos = parent_stream_offset + offset;
     if (!camellia)
     {
-        const auto chunk = parent_stream->read(size);
-        std::memcpy(destination, chunk.get<u8>(), size);
+        parent_stream->read_at(parent_pos, destination, size);
         return;
     }
 
-    const auto old_pos = parent_stream->pos();
-    const auto offset_pad = parent_stream->pos() & 0xF;
-    const auto offset_start = parent_stream->pos() & ~0xF;
+    const auto offset_pad = parent_pos & 0xF;
+    const auto offset_start = parent_pos & ~0xF;
     const auto aligned_size = (offset_pad + size + 0xF) & ~0xF;
     const auto block_count = (aligned_size + 0xF) / 0x10;
     if (block_count == 0)
         return;
 
-    parent_stream->seek(parent_stream_offset
-        + ((parent_stream->pos() - parent_stream_offset) - offset_pad));
-
+    io::MemoryByteStream input_stream(
+        parent_stream->read_at(offset_start, block_count * 16));
     io::MemoryByteStream output_stream;
     output_stream.resize(block_count * 16);
     output_stream.seek(0);
@@ -80,7 +86,7 @@ void CamelliaStream::read_impl(void *destination, const size_t size)
         u32 input_block[4];
         u32 output_block[4];
         for (const auto j : algo::range(4))
-            input_block[j] = parent_stream->read_le<u32>();
+            input_block[j] = input_stream.read_le<u32>();
         camellia->decrypt_block_128(
             offset_start + i * 0x10, input_block, output_block);
         for (const auto j : algo::range(4))
@@ -88,7 +94,6 @@ void CamelliaStream::read_impl(void *destination, const size_t size)
     }
     const auto chunk = output_stream.seek(offset_pad).read(size);
     std::memcpy(destination, chunk.get<u8>(), size);
-    parent_stream->seek(old_pos + size);
 }
 
 void CamelliaStream::write_impl(const void *source, const size_t size)
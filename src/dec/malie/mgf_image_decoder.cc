@@ -36,4 +36,5 @@ res::Image MgfImageDecoder::decode_impl(
     return dec::png::PngImageDecoder().decode(logger, pseudo_file);
 }
 
-static auto _ = dec::register_decoder<MgfImageDecoder>("malie/mgf");
+static auto _ = dec::register_decoder<MgfImageDecoder>("malie/mgf")
+    .add_magic(magic);
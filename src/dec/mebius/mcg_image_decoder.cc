@@ -144,4 +144,5 @@ res::Image McgImageDecoder::decode_impl(
     return output_image;
 }
 
-static auto _ = dec::register_decoder<McgImageDecoder>("mebius/mcg");
+static auto _ = dec::register_decoder<McgImageDecoder>("mebius/mcg")
+    .add_magic(magic);
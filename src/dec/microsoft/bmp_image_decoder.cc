@@ -344,4 +344,5 @@ res::Image BmpImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<BmpImageDecoder>("microsoft/bmp");
+static auto _ = dec::register_decoder<BmpImageDecoder>("microsoft/bmp")
+    .add_magic(magic);
@@ -91,4 +91,5 @@ res::Audio WavAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<WavAudioDecoder>("microsoft/wav");
+static auto _ = dec::register_decoder<WavAudioDecoder>("microsoft/wav")
+    .add_magic(riff_magic);
@@ -47,4 +47,5 @@ res::Image MaskedBmpImageDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<MaskedBmpImageDecoder>(
-    "nekopack/masked-bmp");
+    "nekopack/masked-bmp")
+    .add_extension("alp");
@@ -97,4 +97,5 @@ std::vector<std::string> Nekopack4ArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<Nekopack4ArchiveDecoder>(
-    "nekopack/nekopack4");
+    "nekopack/nekopack4")
+    .add_magic(magic);
@@ -156,4 +156,5 @@ std::unique_ptr<io::File> NpaArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<NpaArchiveDecoder>("nitroplus/npa");
+static auto _ = dec::register_decoder<NpaArchiveDecoder>("nitroplus/npa")
+    .add_magic(magic);
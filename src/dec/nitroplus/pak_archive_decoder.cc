@@ -54,7 +54,7 @@ std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
 
     io::MemoryByteStream table_stream(
         algo::pack::zlib_inflate(
-            input_file.stream.read(table_size_comp)));
+            input_file.stream.read(table_size_comp), table_size_orig));
 
     auto meta = std::make_unique<ArchiveMeta>();
     const auto file_data_offset = input_file.stream.pos();
@@ -88,4 +88,5 @@ std::unique_ptr<io::File> PakArchiveDecoder::read_file_impl(
     return std::make_unique<io::File>(entry->path, data);
 }
 
-static auto _ = dec::register_decoder<PakArchiveDecoder>("nitroplus/pak");
+static auto _ = dec::register_decoder<PakArchiveDecoder>("nitroplus/pak")
+    .add_magic(magic);
@@ -125,4 +125,6 @@ std::unique_ptr<io::File> NsaArchiveDecoder::read_file_impl(
     throw err::NotSupportedError("Unknown compression type");
 }
 
-static auto _ = dec::register_decoder<NsaArchiveDecoder>("nscripter/nsa");
+static auto _ = dec::register_decoder<NsaArchiveDecoder>("nscripter/nsa")
+    .add_extension("nsa")
+    .add_extension("dat");
@@ -93,32 +93,39 @@ void NsaEncryptedStream::seek_impl(const uoff_t offset)
 }
 
 void NsaEncryptedStream::read_impl(void *destination, const size_t size)
+{
+    const auto orig_pos = parent_stream->pos();
+    read_at_impl(orig_pos, destination, size);
+    parent_stream->seek(orig_pos + size);
+}
+
+void NsaEncryptedStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
 {
     if (key.empty())
     {
-        const auto chunk = parent_stream->read(size);
-        std::memcpy(destination, chunk.get<u8>(), size);
+        parent_stream->read_at(offset, destination, size);
         return;
     }
 
-    const auto orig_pos = parent_stream->pos();
-    const auto padded_pos = orig_pos & ~(block_size - 1);
-    const auto offset_pad = orig_pos % block_size;
-    parent_stream->seek(padded_pos);
+    const auto padded_pos = offset & ~(block_size - 1);
+    const auto offset_pad = offset % block_size;
+    const auto parent_size = parent_stream->size();
 
     bstr full_buffer;
+    auto block_pos = padded_pos;
     while (full_buffer.size() < size + offset_pad)
     {
-        const auto block_num = parent_stream->pos() / block_size;
-        auto block = parent_stream->read(
-            std::min<uoff_t>(parent_stream->left(), block_size));
+        if (block_pos >= parent_size)
+            throw err::EofError();
+        const auto block_num = block_pos / block_size;
+        auto block = parent_stream->read_at(
+            block_pos, std::min<uoff_t>(parent_size - block_pos, block_size));
         transform_block(key, block_num, block);
         full_buffer += block;
+        block_pos += block.size();
     }
-    if (full_buffer.size() < size)
-        throw err::BadDataSizeError();
     std::memcpy(destination, full_buffer.get<const u8>() + offset_pad, size);
-    parent_stream->seek(orig_pos + size);
 }
 
 void NsaEncryptedStream::write_impl(const void *source, const size_t size)
@@ -35,6 +35,10 @@ namespace nscripter {
 
     protected:
         void read_impl(void *destination, const size_t size) override;
+        void read_at_impl(
+            const uoff_t offset,
+            void *destination,
+            const size_t size) override;
         void write_impl(const void *source, const size_t size) override;
         void seek_impl(const uoff_t offset) override;
         void resize_impl(const uoff_t new_size) override;
@@ -70,4 +70,5 @@ std::vector<std::string> FjsysArchiveDecoder::get_linked_formats() const
     return {"nsystem/mgd"};
 }
 
-static auto _ = dec::register_decoder<FjsysArchiveDecoder>("nsystem/fjsys");
+static auto _ = dec::register_decoder<FjsysArchiveDecoder>("nsystem/fjsys")
+    .add_magic(magic);
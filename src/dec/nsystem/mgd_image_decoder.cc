@@ -270,4 +270,5 @@ res::Image MgdImageDecoder::decode_impl(
     return image;
 }
 
-static auto _ = dec::register_decoder<MgdImageDecoder>("nsystem/mgd");
+static auto _ = dec::register_decoder<MgdImageDecoder>("nsystem/mgd")
+    .add_magic(magic);
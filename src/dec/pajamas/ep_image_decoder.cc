@@ -130,4 +130,5 @@ res::Image EpImageDecoder::decode_impl(
 }
 
 static auto _
-    = dec::register_decoder<EpImageDecoder>("pajamas/ep");
+    = dec::register_decoder<EpImageDecoder>("pajamas/ep")
+    .add_magic(magic);
@@ -95,4 +95,5 @@ std::vector<std::string> GamedatArchiveDecoder::get_linked_formats() const
 }
 
 static auto _
-    = dec::register_decoder<GamedatArchiveDecoder>("pajamas/gamedat");
+    = dec::register_decoder<GamedatArchiveDecoder>("pajamas/gamedat")
+    .add_magic(magic);
@@ -75,4 +75,5 @@ std::vector<std::string> MpkArchiveDecoder::get_linked_formats() const
     return {"propeller/mgr"};
 }
 
-static auto _ = dec::register_decoder<MpkArchiveDecoder>("propeller/mpk");
+static auto _ = dec::register_decoder<MpkArchiveDecoder>("propeller/mpk")
+    .add_extension("mpk");
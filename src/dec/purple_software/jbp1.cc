@@ -77,7 +77,7 @@ u32 CustomBitStream::read(const size_t bits)
     {
         if (!bits_available)
         {
-            buffer = input_stream->read<u8>();
+            buffer = read_byte();
             bits_available = 8;
         }
         ret <<= 1;
@@ -442,4 +442,5 @@ res::Image Pb3ImageDecoder::decode_impl(
         "Unsupported type: %d.%d", header.main_type, header.sub_type));
 }
 
-static auto _ = dec::register_decoder<Pb3ImageDecoder>("purple-software/pb3");
+static auto _ = dec::register_decoder<Pb3ImageDecoder>("purple-software/pb3")
+    .add_magic(magic);
@@ -68,8 +68,7 @@ std::unique_ptr<io::File> Abmp7ArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    auto output_file = std::make_unique<io::File>(entry->path, data);
+    auto output_file = open_plain_entry(input_file, *entry);
     output_file->guess_extension();
     return output_file;
 }
@@ -79,4 +78,5 @@ std::vector<std::string> Abmp7ArchiveDecoder::get_linked_formats() const
     return {"qlie/abmp7", "qlie/abmp10", "qlie/dpng"};
 }
 
-static auto _ = dec::register_decoder<Abmp7ArchiveDecoder>("qlie/abmp7");
+static auto _ = dec::register_decoder<Abmp7ArchiveDecoder>("qlie/abmp7")
+    .add_magic(magic);
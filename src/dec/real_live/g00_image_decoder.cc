@@ -197,4 +197,5 @@ res::Image G00ImageDecoder::decode_impl(
     throw err::UnsupportedVersionError(version);
 }
 
-static auto _ = dec::register_decoder<G00ImageDecoder>("real-live/g00");
+static auto _ = dec::register_decoder<G00ImageDecoder>("real-live/g00")
+    .add_extension("g00");
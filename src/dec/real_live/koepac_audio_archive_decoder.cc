@@ -205,4 +205,5 @@ std::unique_ptr<io::File> KoepacAudioArchiveDecoder::read_file_impl(
 }
 
 static auto _
-    = dec::register_decoder<KoepacAudioArchiveDecoder>("real-live/koepac");
+    = dec::register_decoder<KoepacAudioArchiveDecoder>("real-live/koepac")
+    .add_magic(magic);
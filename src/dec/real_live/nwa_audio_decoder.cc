@@ -235,4 +235,5 @@ res::Audio NwaAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<NwaAudioDecoder>("real-live/nwa");
+static auto _ = dec::register_decoder<NwaAudioDecoder>("real-live/nwa")
+    .add_extension("nwa");
@@ -51,9 +51,9 @@ std::unique_ptr<io::File> NwkArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    return std::make_unique<io::File>(
-        io::path(entry->path).change_extension("nwa"), data);
+    auto output_file = open_plain_entry(input_file, *entry);
+    output_file->path.change_extension("nwa");
+    return output_file;
 }
 
 std::vector<std::string> NwkArchiveDecoder::get_linked_formats() const
@@ -61,4 +61,5 @@ std::vector<std::string> NwkArchiveDecoder::get_linked_formats() const
     return {"real-live/nwa"};
 }
 
-static auto _ = dec::register_decoder<NwkArchiveDecoder>("real-live/nwk");
+static auto _ = dec::register_decoder<NwkArchiveDecoder>("real-live/nwk")
+    .add_extension("nwk");
@@ -52,10 +52,10 @@ std::unique_ptr<io::File> OvkArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    auto output_file = std::make_unique<io::File>(entry->path, data);
+    auto output_file = open_plain_entry(input_file, *entry);
     output_file->guess_extension();
     return output_file;
 }
 
-static auto _ = dec::register_decoder<OvkArchiveDecoder>("real-live/ovk");
+static auto _ = dec::register_decoder<OvkArchiveDecoder>("real-live/ovk")
+    .add_extension("ovk");
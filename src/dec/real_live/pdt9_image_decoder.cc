@@ -84,4 +84,5 @@ res::Image Pdt9ImageDecoder::decode_impl(
     return res::Image(total_width, total_height, output, palette);
 }
 
-static auto _ = dec::register_decoder<Pdt9ImageDecoder>("real-live/pdt9");
+static auto _ = dec::register_decoder<Pdt9ImageDecoder>("real-live/pdt9")
+    .add_extension("pdt");
@@ -18,16 +18,59 @@
 #include "dec/registry.h"
 #include <algorithm>
 #include <map>
+#include <mutex>
+#include "algo/str.h"
 #include "dec/idecoder.h"
 #include "err.h"
 
+using namespace au;
 using namespace au::dec;
 
+namespace
+{
+    // Byte-wise trie of the magics located at offset 0.
+    struct MagicTrieNode final
+    {
+        std::map<u8, size_t> children;
+        std::vector<std::string> names;
+    };
+
+    struct OffsetMagic final
+    {
+        std::string name;
+        uoff_t offset;
+        bstr magic;
+    };
+}
+
+static std::string normalize_extension(const std::string &extension)
+{
+    auto output = algo::lower(extension);
+    while (!output.empty() && output[0] == '.')
+        output.erase(0, 1);
+    return output;
+}
+
 struct Registry::Priv final
 {
+    Priv();
+
     std::map<std::string, DecoderCreator> decoder_map;
+
+    std::mutex prototype_mutex;
+    std::map<std::string, std::shared_ptr<const IDecoder>> prototype_map;
+
+    std::set<std::string> hinted_names;
+    std::vector<MagicTrieNode> magic_trie;
+    std::vector<OffsetMagic> offset_magics;
+    std::map<std::string, std::vector<std::string>> extension_map;
+    size_t header_size;
 };
 
+Registry::Priv::Priv() : magic_trie(1), header_size(0)
+{
+}
+
 Registry::Registry() : p(new Priv)
 {
 }
@@ -58,6 +101,22 @@ std::shared_ptr<IDecoder>
     return p->decoder_map[name]();
 }
 
+std::shared_ptr<const IDecoder>
+    Registry::get_decoder_prototype(const std::string &name) const
+{
+    {
+        std::unique_lock<std::mutex> lock(p->prototype_mutex);
+        const auto it = p->prototype_map.find(name);
+        if (it != p->prototype_map.end())
+            return it->second;
+    }
+
+    // create outside the lock - if two threads race, one copy is discarded
+    std::shared_ptr<const IDecoder> decoder = create_decoder(name);
+    std::unique_lock<std::mutex> lock(p->prototype_mutex);
+    return p->prototype_map.insert({name, decoder}).first->second;
+}
+
 void Registry::add_decoder(const std::string &name, DecoderCreator creator)
 {
     if (has_decoder(name))
@@ -68,6 +127,105 @@ void Registry::add_decoder(const std::string &name, DecoderCreator creator)
     p->decoder_map[name] = creator;
 }
 
+void Registry::add_magic(
+    const std::string &name, const bstr &magic, const uoff_t offset)
+{
+    if (magic.empty())
+        throw std::logic_error("Empty magic for decoder " + name);
+    p->hinted_names.insert(name);
+    p->header_size = std::max<size_t>(p->header_size, offset + magic.size());
+
+    if (offset)
+    {
+        p->offset_magics.push_back({name, offset, magic});
+        return;
+    }
+
+    size_t node = 0;
+    for (const auto c : magic)
+    {
+        const auto it = p->magic_trie[node].children.find(c);
+        if (it != p->magic_trie[node].children.end())
+        {
+            node = it->second;
+            continue;
+        }
+        p->magic_trie[node].children[c] = p->magic_trie.size();
+        node = p->magic_trie.size();
+        p->magic_trie.push_back(MagicTrieNode());
+    }
+    p->magic_trie[node].names.push_back(name);
+}
+
+void Registry::add_extension(
+    const std::string &name, const std::string &extension)
+{
+    p->hinted_names.insert(name);
+    p->extension_map[normalize_extension(extension)].push_back(name);
+}
+
+std::set<std::string> Registry::get_candidate_decoder_names(
+    const std::set<std::string> &names, io::File &input_file) const
+{
+    std::set<std::string> matching_names;
+
+    const auto extension_it = p->extension_map.find(
+        normalize_extension(input_file.path.extension()));
+    if (extension_it != p->extension_map.end())
+    {
+        matching_names.insert(
+            extension_it->second.begin(), extension_it->second.end());
+    }
+
+    if (p->header_size)
+    {
+        bstr header;
+        try
+        {
+            input_file.stream.seek(0);
+            header = input_file.stream.read(std::min<uoff_t>(
+                p->header_size, input_file.stream.size()));
+        }
+        catch (const std::exception &)
+        {
+        }
+
+        size_t node = 0;
+        for (const auto c : header)
+        {
+            const auto it = p->magic_trie[node].children.find(c);
+            if (it == p->magic_trie[node].children.end())
+                break;
+            node = it->second;
+            matching_names.insert(
+                p->magic_trie[node].names.begin(),
+                p->magic_trie[node].names.end());
+        }
+
+        for (const auto &offset_magic : p->offset_magics)
+        {
+            if (offset_magic.offset + offset_magic.magic.size() > header.size())
+                continue;
+            if (header.substr(offset_magic.offset, offset_magic.magic.size())
+                    == offset_magic.magic)
+            {
+                matching_names.insert(offset_magic.name);
+            }
+        }
+    }
+
+    std::set<std::string> candidate_names;
+    for (const auto &name : names)
+    {
+        if (p->hinted_names.find(name) == p->hinted_names.end()
+            || matching_names.find(name) != matching_names.end())
+        {
+            candidate_names.insert(name);
+        }
+    }
+    return candidate_names;
+}
+
 Registry &Registry::instance()
 {
     static Registry instance;
@@ -78,3 +236,23 @@ std::unique_ptr<Registry> Registry::create_mock()
 {
     return std::unique_ptr<Registry>(new Registry());
 }
+
+DecoderRegistration::DecoderRegistration(
+    Registry &registry, const std::string &name)
+        : registry(registry), name(name)
+{
+}
+
+DecoderRegistration &DecoderRegistration::add_magic(
+    const bstr &magic, const uoff_t offset)
+{
+    registry.add_magic(name, magic, offset);
+    return *this;
+}
+
+DecoderRegistration &DecoderRegistration::add_extension(
+    const std::string &extension)
+{
+    registry.add_extension(name, extension);
+    return *this;
+}
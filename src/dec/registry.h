@@ -19,7 +19,9 @@
 
 #include <functional>
 #include <memory>
+#include <set>
 #include <vector>
+#include "io/file.h"
 
 namespace au {
 namespace dec {
@@ -42,6 +44,25 @@ namespace dec {
         void add_decoder(const std::string &name, DecoderCreator creator);
         std::shared_ptr<IDecoder> create_decoder(const std::string &name) const;
 
+        // Returns a decoder that is created once and then shared by all the
+        // callers. It must not be reconfigured - use create_decoder() to
+        // obtain an instance that can be passed CLI options.
+        std::shared_ptr<const IDecoder> get_decoder_prototype(
+            const std::string &name) const;
+
+        // Recognition hints are optional. A decoder that declares at least
+        // one hint is considered a candidate for a file only when any of its
+        // hints match, which lets the caller skip creating the decoder
+        // altogether. Hints must therefore be necessary conditions of the
+        // decoder's is_recognized_impl().
+        void add_magic(
+            const std::string &name, const bstr &magic, const uoff_t offset);
+        void add_extension(
+            const std::string &name, const std::string &extension);
+
+        std::set<std::string> get_candidate_decoder_names(
+            const std::set<std::string> &names, io::File &input_file) const;
+
     private:
         Registry();
 
@@ -49,12 +70,26 @@ namespace dec {
         std::unique_ptr<Priv> p;
     };
 
-    template <typename T, typename ...Params> bool register_decoder(
-        const std::string &name, Params&&... params)
+    class DecoderRegistration final
+    {
+    public:
+        DecoderRegistration(Registry &registry, const std::string &name);
+
+        DecoderRegistration &add_magic(
+            const bstr &magic, const uoff_t offset = 0);
+        DecoderRegistration &add_extension(const std::string &extension);
+
+    private:
+        Registry &registry;
+        std::string name;
+    };
+
+    template <typename T, typename ...Params> DecoderRegistration
+        register_decoder(const std::string &name, Params&&... params)
     {
         Registry::instance().add_decoder(
             name, [=]() { return std::make_shared<T>(params...); });
-        return true;
+        return DecoderRegistration(Registry::instance(), name);
     }
 
 } }
@@ -49,4 +49,5 @@ res::Image CmpImageDecoder::decode_impl(
     return bmp_image_decoder.decode(logger, bmp_file);
 }
 
-static auto _ = dec::register_decoder<CmpImageDecoder>("riddle-soft/cmp");
+static auto _ = dec::register_decoder<CmpImageDecoder>("riddle-soft/cmp")
+    .add_magic(magic);
@@ -66,4 +66,5 @@ std::unique_ptr<io::File> Rgss3aArchiveDecoder::read_file_impl(
         input_file, *static_cast<const rgs::CustomArchiveEntry*>(&e));
 }
 
-static auto _ = dec::register_decoder<Rgss3aArchiveDecoder>("rpgmaker/rgss3a");
+static auto _ = dec::register_decoder<Rgss3aArchiveDecoder>("rpgmaker/rgss3a")
+    .add_magic(magic);
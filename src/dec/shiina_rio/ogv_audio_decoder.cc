@@ -49,4 +49,5 @@ std::unique_ptr<io::File> OgvAudioDecoder::decode_impl(
     return output_file;
 }
 
-static auto _ = dec::register_decoder<OgvAudioDecoder>("shiina-rio/ogv");
+static auto _ = dec::register_decoder<OgvAudioDecoder>("shiina-rio/ogv")
+    .add_magic(magic);
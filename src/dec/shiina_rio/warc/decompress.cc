@@ -44,15 +44,18 @@ CustomBitStream::CustomBitStream(const bstr &input) : io::BaseBitStream(input)
 
 void CustomBitStream::fetch()
 {
-    if (input_stream->left() >= 4)
+    if (bytes_left() >= 4)
     {
-        buffer = input_stream->read_le<u32>();
+        buffer = read_byte();
+        buffer |= read_byte() << 8;
+        buffer |= read_byte() << 16;
+        buffer |= static_cast<u32>(read_byte()) << 24;
         return;
     }
-    while (input_stream->left())
+    while (bytes_left())
     {
         buffer <<= 8;
-        buffer |= input_stream->read<u8>();
+        buffer |= read_byte();
     }
 }
 
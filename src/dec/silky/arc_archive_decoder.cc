@@ -80,4 +80,5 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
     return {"silky/akb"};
 }
 
-static auto _ = dec::register_decoder<ArcArchiveDecoder>("silky/arc");
+static auto _ = dec::register_decoder<ArcArchiveDecoder>("silky/arc")
+    .add_extension("arc");
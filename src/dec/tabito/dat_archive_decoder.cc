@@ -66,8 +66,7 @@ std::unique_ptr<io::File> DatArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    auto ret = std::make_unique<io::File>(entry->path, data);
+    auto ret = open_plain_entry(input_file, *entry);
     ret->guess_extension();
     return ret;
 }
@@ -77,4 +76,5 @@ std::vector<std::string> DatArchiveDecoder::get_linked_formats() const
     return {"tabito/gwd"};
 }
 
-static auto _ = dec::register_decoder<DatArchiveDecoder>("tabito/dat");
+static auto _ = dec::register_decoder<DatArchiveDecoder>("tabito/dat")
+    .add_extension("dat");
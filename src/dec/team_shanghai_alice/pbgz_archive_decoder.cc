@@ -171,4 +171,5 @@ std::vector<std::string> PbgzArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<PbgzArchiveDecoder>(
-    "team-shanghai-alice/pbgz");
+    "team-shanghai-alice/pbgz")
+    .add_magic(magic);
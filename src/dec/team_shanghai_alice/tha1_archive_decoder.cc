@@ -204,4 +204,5 @@ std::vector<std::string> Tha1ArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<Tha1ArchiveDecoder>(
-    "team-shanghai-alice/tha1");
+    "team-shanghai-alice/tha1")
+    .add_extension("dat");
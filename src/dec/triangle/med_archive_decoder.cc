@@ -66,4 +66,5 @@ std::vector<std::string> MedArchiveDecoder::get_linked_formats() const
     return {"triangle/yb", "triangle/wady"};
 }
 
-static auto _ = dec::register_decoder<MedArchiveDecoder>("triangle/med");
+static auto _ = dec::register_decoder<MedArchiveDecoder>("triangle/med")
+    .add_magic(magic);
@@ -97,4 +97,5 @@ std::unique_ptr<io::File> Pak1AudioArchiveDecoder::read_file_impl(
 }
 
 static auto _ = dec::register_decoder<Pak1AudioArchiveDecoder>(
-    "twilight-frontier/pak1-sfx");
+    "twilight-frontier/pak1-sfx")
+    .add_extension("dat");
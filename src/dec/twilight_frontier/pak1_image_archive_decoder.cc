@@ -155,4 +155,5 @@ std::unique_ptr<io::File> Pak1ImageArchiveDecoder::read_file_impl(
 }
 
 static auto _ = dec::register_decoder<Pak1ImageArchiveDecoder>(
-    "twilight-frontier/pak1-gfx");
+    "twilight-frontier/pak1-gfx")
+    .add_extension("dat");
@@ -47,4 +47,5 @@ res::Audio Pak2AudioDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<Pak2AudioDecoder>(
-    "twilight-frontier/pak2-sfx");
+    "twilight-frontier/pak2-sfx")
+    .add_extension("cv3");
@@ -92,4 +92,5 @@ res::Image Pak2ImageDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<Pak2ImageDecoder>(
-    "twilight-frontier/pak2-gfx");
+    "twilight-frontier/pak2-gfx")
+    .add_extension("cv2");
@@ -318,7 +318,8 @@ static HashLookupMap read_fn_map(
 
     tmp_stream->seek(0);
     tmp_stream = std::make_unique<io::MemoryByteStream>(
-        algo::pack::zlib_inflate(tmp_stream->read(table_size_comp)));
+        algo::pack::zlib_inflate(
+            tmp_stream->read(table_size_comp), table_size_orig));
 
     for (const auto &dir_entry : dir_entries)
     {
@@ -479,4 +480,5 @@ std::vector<std::string> TfpkArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<TfpkArchiveDecoder>(
-    "twilight-frontier/tfpk");
+    "twilight-frontier/tfpk")
+    .add_magic(magic);
@@ -50,4 +50,5 @@ res::Audio TfwaAudioDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<TfwaAudioDecoder>(
-    "twilight-frontier/tfwa");
+    "twilight-frontier/tfwa")
+    .add_magic(magic);
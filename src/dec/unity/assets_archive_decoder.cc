@@ -94,8 +94,7 @@ std::unique_ptr<io::File> AssetsArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    return std::make_unique<io::File>(entry->path, data);
+    return open_plain_entry(input_file, *entry);
 }
 
 static auto _ = dec::register_decoder<AssetsArchiveDecoder>("unity/assets");
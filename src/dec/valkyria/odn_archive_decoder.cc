@@ -254,4 +254,5 @@ std::unique_ptr<io::File> OdnArchiveDecoder::read_file_impl(
     return ret;
 }
 
-static auto _ = dec::register_decoder<OdnArchiveDecoder>("valkyria/odn");
+static auto _ = dec::register_decoder<OdnArchiveDecoder>("valkyria/odn")
+    .add_extension("odn");
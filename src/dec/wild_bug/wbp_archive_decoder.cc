@@ -111,4 +111,5 @@ std::vector<std::string> WbpArchiveDecoder::get_linked_formats() const
     return {"wild-bug/wbi", "wild-bug/wbm", "wild-bug/wpn", "wild-bug/wwa"};
 }
 
-static auto _ = dec::register_decoder<WbpArchiveDecoder>("wild-bug/wbp");
+static auto _ = dec::register_decoder<WbpArchiveDecoder>("wild-bug/wbp")
+    .add_magic(magic);
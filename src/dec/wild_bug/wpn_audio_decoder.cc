@@ -78,4 +78,5 @@ res::Audio WpnAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<WpnAudioDecoder>("wild-bug/wpn");
+static auto _ = dec::register_decoder<WpnAudioDecoder>("wild-bug/wpn")
+    .add_magic(magic);
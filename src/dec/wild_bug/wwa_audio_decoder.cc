@@ -53,4 +53,5 @@ res::Audio WwaAudioDecoder::decode_impl(
     return audio;
 }
 
-static auto _ = dec::register_decoder<WwaAudioDecoder>("wild-bug/wwa");
+static auto _ = dec::register_decoder<WwaAudioDecoder>("wild-bug/wwa")
+    .add_magic(magic);
@@ -73,4 +73,5 @@ std::vector<std::string> YkcArchiveDecoder::get_linked_formats() const
     return {"yuka-script/ykg"};
 }
 
-static auto _ = dec::register_decoder<YkcArchiveDecoder>("yuka-script/ykc");
+static auto _ = dec::register_decoder<YkcArchiveDecoder>("yuka-script/ykc")
+    .add_magic(magic);
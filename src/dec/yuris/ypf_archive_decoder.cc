@@ -207,4 +207,5 @@ std::vector<std::string> YpfArchiveDecoder::get_linked_formats() const
     return {"yuris/ycg"};
 }
 
-static auto _ = dec::register_decoder<YpfArchiveDecoder>("yuris/ypf");
+static auto _ = dec::register_decoder<YpfArchiveDecoder>("yuris/ypf")
+    .add_magic(magic);
@@ -405,4 +405,5 @@ std::unique_ptr<io::File> PsbImageArchiveDecoder::read_file_impl(
     return enc::png::PngImageEncoder().encode(logger, *image, entry->path);
 }
 
-static auto _ = dec::register_decoder<PsbImageArchiveDecoder>("yuzusoft/psb");
+static auto _ = dec::register_decoder<PsbImageArchiveDecoder>("yuzusoft/psb")
+    .add_magic(magic);
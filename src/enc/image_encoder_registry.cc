@@ -0,0 +1,67 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "enc/image_encoder_registry.h"
+#include <functional>
+#include "enc/microsoft/bmp_image_encoder.h"
+#include "enc/netpbm/pam_image_encoder.h"
+#include "enc/png/png_image_encoder.h"
+#include "err.h"
+
+using namespace au;
+using namespace au::enc;
+
+using ImageEncoderCreator = std::function<std::unique_ptr<BaseImageEncoder>()>;
+
+static std::unique_ptr<BaseImageEncoder> create_png_encoder(
+    const png::PngEncodeProfile profile)
+{
+    return std::make_unique<png::PngImageEncoder>(profile);
+}
+
+static const std::vector<std::pair<std::string, ImageEncoderCreator>>
+    creators =
+{
+    {"png", []() { return create_png_encoder(png::PngEncodeProfile::Fast); }},
+    {"png-store",
+        []() { return create_png_encoder(png::PngEncodeProfile::Store); }},
+    {"png-balanced",
+        []() { return create_png_encoder(png::PngEncodeProfile::Balanced); }},
+    {"png-small",
+        []() { return create_png_encoder(png::PngEncodeProfile::Small); }},
+    {"bmp",
+        []() { return std::make_unique<microsoft::BmpImageEncoder>(); }},
+    {"pam",
+        []() { return std::make_unique<netpbm::PamImageEncoder>(); }},
+};
+
+std::vector<std::string> enc::get_image_encoder_names()
+{
+    std::vector<std::string> names;
+    for (const auto &item : creators)
+        names.push_back(item.first);
+    return names;
+}
+
+std::unique_ptr<BaseImageEncoder> enc::create_image_encoder(
+    const std::string &name)
+{
+    for (const auto &item : creators)
+        if (item.first == name)
+            return item.second();
+    throw err::UsageError("Unknown image format: " + name);
+}
@@ -16,7 +16,6 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "enc/microsoft/bmp_image_encoder.h"
-#include "algo/range.h"
 
 using namespace au;
 using namespace au::enc::microsoft;
@@ -28,7 +27,7 @@ void BmpImageEncoder::encode_impl(
 {
     const auto width = input_image.width();
     const auto height = input_image.height();
-    const auto stride = ((width * 4) + 3) & ~3;
+    const auto stride = width * 4;
 
     // BITMAPFILEHEADER
     output_file.stream.write("BM"_b);
@@ -50,17 +49,13 @@ void BmpImageEncoder::encode_impl(
     output_file.stream.write_le<u32>(0);        // biClrUsed
     output_file.stream.write_le<u32>(0);        // biClrImportant
 
-    for (const auto y : algo::range(height))
+    // 32-bit rows need no padding and res::Pixel is already laid out as
+    // BGRA, so the pixels can be written in one go.
+    if (width && height)
     {
-        for (const auto x : algo::range(width))
-        {
-            const auto &c = input_image.at(x, y);
-            output_file.stream.write<u8>(c.b);
-            output_file.stream.write<u8>(c.g);
-            output_file.stream.write<u8>(c.r);
-            output_file.stream.write<u8>(c.a);
-        }
-        output_file.stream.write(bstr(stride - 4 * width));
+        output_file.stream.write(bstr(
+            reinterpret_cast<const u8*>(&input_image.at(0, 0)),
+            stride * height));
     }
 
     output_file.path.change_extension("bmp");
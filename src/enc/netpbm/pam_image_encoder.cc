@@ -0,0 +1,54 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "enc/netpbm/pam_image_encoder.h"
+#include "algo/format.h"
+#include "algo/range.h"
+
+using namespace au;
+using namespace au::enc::netpbm;
+
+void PamImageEncoder::encode_impl(
+    const Logger &logger,
+    const res::Image &input_image,
+    io::File &output_file) const
+{
+    const auto width = input_image.width();
+    const auto height = input_image.height();
+
+    output_file.stream.write(algo::format(
+        "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\n"
+        "TUPLTYPE RGB_ALPHA\nENDHDR\n",
+        static_cast<int>(width),
+        static_cast<int>(height)));
+
+    bstr samples;
+    samples.resize_uninitialized(width * height * 4);
+    auto samples_ptr = samples.get<u8>();
+    for (const auto y : algo::range(height))
+    for (const auto x : algo::range(width))
+    {
+        const auto &c = input_image.at(x, y);
+        *samples_ptr++ = c.r;
+        *samples_ptr++ = c.g;
+        *samples_ptr++ = c.b;
+        *samples_ptr++ = c.a;
+    }
+    output_file.stream.write(samples);
+
+    output_file.path.change_extension("pam");
+}
@@ -14,9 +14,15 @@
 //
 // You should have received a copy of the GNU General Public License
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
-
 #include "enc/png/png_image_encoder.h"
 #include <png.h>
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include "algo/idle_helpers.h"
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
@@ -24,6 +30,356 @@
 using namespace au;
 using namespace au::enc::png;
 
+namespace
+{
+    struct ProfileSettings final
+    {
+        int compression_level;
+        bool adaptive_filtering;
+    };
+
+    // Produces PNG scanlines (filter type byte + filtered RGBA samples).
+    class RowFilter final
+    {
+    public:
+        RowFilter(const res::Image &image, const bool adaptive_filtering);
+        void filter(const size_t y, u8 *output);
+
+    private:
+        void read_row(const size_t y, std::vector<u8> &output) const;
+
+        const res::Image &image;
+        const bool adaptive_filtering;
+        const size_t stride;
+        std::vector<u8> current_row;
+        std::vector<u8> previous_row;
+        std::vector<u8> candidate;
+    };
+}
+
+// Images whose scanlines take more than this many bytes are cut into bands
+// of about this size, which are deflated independently on all cores.
+static const size_t band_size = 1024 * 1024;
+
+// How far back deflate can look for matches; each band is primed with this
+// much of the data preceding it.
+static const size_t window_size = 32 * 1024;
+
+// How much of the image is used to decide whether to filter it.
+static const size_t sample_size = 256 * 1024;
+
+static const bstr png_magic = "\x89PNG\x0D\x0A\x1A\x0A"_b;
+
+static ProfileSettings get_profile_settings(const PngEncodeProfile profile)
+{
+    switch (profile)
+    {
+        case PngEncodeProfile::Store:
+            return {0, false};
+        case PngEncodeProfile::Fast:
+            return {1, false};
+        case PngEncodeProfile::Balanced:
+            return {6, true};
+        case PngEncodeProfile::Small:
+            return {9, true};
+    }
+    throw std::logic_error("Unknown PNG encode profile");
+}
+
+static int paeth_predictor(const int a, const int b, const int c)
+{
+    const auto p = a + b - c;
+    const auto pa = std::abs(p - a);
+    const auto pb = std::abs(p - b);
+    const auto pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    if (pb <= pc)
+        return b;
+    return c;
+}
+
+RowFilter::RowFilter(const res::Image &image, const bool adaptive_filtering) :
+        image(image),
+        adaptive_filtering(adaptive_filtering),
+        stride(image.width() * 4),
+        current_row(stride),
+        previous_row(stride),
+        candidate(stride)
+{
+}
+
+void RowFilter::read_row(const size_t y, std::vector<u8> &output) const
+{
+    const auto *input_ptr = &image.at(0, y);
+    auto *output_ptr = output.data();
+    for (const auto x : algo::range(image.width()))
+    {
+        *output_ptr++ = input_ptr[x].r;
+        *output_ptr++ = input_ptr[x].g;
+        *output_ptr++ = input_ptr[x].b;
+        *output_ptr++ = input_ptr[x].a;
+    }
+}
+
+void RowFilter::filter(const size_t y, u8 *output)
+{
+    read_row(y, current_row);
+    output[0] = 0;
+    std::memcpy(output + 1, current_row.data(), stride);
+    if (!adaptive_filtering)
+        return;
+
+    if (y)
+        read_row(y - 1, previous_row);
+    else
+        std::fill(previous_row.begin(), previous_row.end(), 0);
+
+    // Pick the filter that minimizes the sum of absolute differences, which
+    // is the heuristic recommended by the PNG specification.
+    const auto get_cost = [&](const u8 *samples)
+    {
+        size_t cost = 0;
+        for (const auto i : algo::range(stride))
+            cost += std::abs(static_cast<s8>(samples[i]));
+        return cost;
+    };
+
+    auto best_cost = get_cost(output + 1);
+    for (const auto filter_type : algo::range(1, 5))
+    {
+        for (const auto i : algo::range(stride))
+        {
+            const int x = current_row[i];
+            const int a = i >= 4 ? current_row[i - 4] : 0;
+            const int b = previous_row[i];
+            const int c = i >= 4 ? previous_row[i - 4] : 0;
+            int prediction = 0;
+            if (filter_type == 1)
+                prediction = a;
+            else if (filter_type == 2)
+                prediction = b;
+            else if (filter_type == 3)
+                prediction = (a + b) >> 1;
+            else
+                prediction = paeth_predictor(a, b, c);
+            candidate[i] = x - prediction;
+        }
+        const auto cost = get_cost(candidate.data());
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            output[0] = filter_type;
+            std::memcpy(output + 1, candidate.data(), stride);
+        }
+    }
+}
+
+static bstr filter_rows(
+    const res::Image &image,
+    const bool adaptive_filtering,
+    const size_t y_start,
+    const size_t y_end)
+{
+    const auto scanline_size = 1 + image.width() * 4;
+    RowFilter row_filter(image, adaptive_filtering);
+    bstr output;
+    output.resize_uninitialized((y_end - y_start) * scanline_size);
+    auto output_ptr = output.get<u8>();
+    for (const auto y : algo::range(y_start, y_end))
+    {
+        row_filter.filter(y, output_ptr);
+        output_ptr += scanline_size;
+    }
+    return output;
+}
+
+// Produces a raw deflate fragment. Fragments other than the last end on a
+// byte boundary thanks to Z_SYNC_FLUSH, so they can simply be concatenated.
+static bstr deflate_band(
+    const bstr &input,
+    const bstr &dictionary,
+    const ProfileSettings &settings,
+    const bool is_last)
+{
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(
+            &stream,
+            settings.compression_level,
+            Z_DEFLATED,
+            -15,
+            8,
+            Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw std::logic_error("Failed to initialize zlib stream");
+    }
+
+    if (!dictionary.empty())
+    {
+        deflateSetDictionary(
+            &stream, dictionary.get<const u8>(), dictionary.size());
+    }
+
+    // The bound covers Z_FINISH; the margin covers the empty stored block
+    // emitted by Z_SYNC_FLUSH.
+    bstr output;
+    output.resize_uninitialized(deflateBound(&stream, input.size()) + 64);
+    stream.next_in = const_cast<u8*>(input.get<const u8>());
+    stream.avail_in = input.size();
+    stream.next_out = output.get<u8>();
+    stream.avail_out = output.size();
+    const auto result = deflate(&stream, is_last ? Z_FINISH : Z_SYNC_FLUSH);
+    const auto output_size = stream.total_out;
+    const auto input_left = stream.avail_in;
+    deflateEnd(&stream);
+
+    if (result != (is_last ? Z_STREAM_END : Z_OK) || input_left)
+        throw std::logic_error("Failed to deflate PNG image data");
+    output.resize(output_size);
+    return output;
+}
+
+// Adaptive filtering pays off on photographic images, but inflates dithered
+// and flat-colored artwork, so try both on a sample of rows from the middle
+// of the image and keep whichever deflates better.
+static bool is_filtering_worthwhile(const res::Image &image)
+{
+    const auto scanline_size = 1 + image.width() * 4;
+    const auto sample_rows = std::min(
+        image.height(), std::max<size_t>(1, sample_size / scanline_size));
+    const auto y_start = (image.height() - sample_rows) / 2;
+    const auto y_end = y_start + sample_rows;
+    const ProfileSettings sample_settings = {1, false};
+    const auto get_deflated_size = [&](const bool adaptive_filtering)
+    {
+        const auto input
+            = filter_rows(image, adaptive_filtering, y_start, y_end);
+        return deflate_band(input, ""_b, sample_settings, true).size();
+    };
+    return get_deflated_size(true) < get_deflated_size(false);
+}
+
+static void write_chunk(
+    io::BaseByteStream &output_stream, const bstr &type, const bstr &data)
+{
+    auto crc = ::crc32(0, type.get<const u8>(), type.size());
+    // zlib treats a null buffer as a request for the initial value
+    if (!data.empty())
+        crc = ::crc32(crc, data.get<const u8>(), data.size());
+    output_stream.write_be<u32>(data.size());
+    output_stream.write(type);
+    output_stream.write(data);
+    output_stream.write_be<u32>(crc);
+}
+
+// Same approach as pigz: each band is compressed on its own, primed with the
+// tail of the preceding data, and the fragments are stitched into a single
+// zlib stream whose checksum is combined from the per-band checksums.
+// The band layout does not depend on the number of cores, so the output is
+// the same on every machine.
+static void encode_in_bands(
+    const res::Image &input_image,
+    const ProfileSettings &settings,
+    const size_t rows_per_band,
+    io::BaseByteStream &output_stream)
+{
+    const auto width = input_image.width();
+    const auto height = input_image.height();
+    const auto scanline_size = 1 + width * 4;
+    const auto band_count = (height + rows_per_band - 1) / rows_per_band;
+    const auto dictionary_rows
+        = (window_size + scanline_size - 1) / scanline_size;
+
+    std::vector<bstr> bands(band_count);
+    std::vector<u32> checksums(band_count);
+    std::vector<size_t> band_sizes(band_count);
+    std::atomic<size_t> next_band(0);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    const auto work = [&]()
+    {
+        try
+        {
+            while (true)
+            {
+                const size_t i = next_band++;
+                if (i >= band_count)
+                    break;
+                const auto y_start = i * rows_per_band;
+                const auto y_end = std::min(height, y_start + rows_per_band);
+                const auto input = filter_rows(
+                    input_image, settings.adaptive_filtering, y_start, y_end);
+                bstr dictionary;
+                if (y_start)
+                {
+                    dictionary = filter_rows(
+                        input_image,
+                        settings.adaptive_filtering,
+                        y_start - std::min(y_start, dictionary_rows),
+                        y_start);
+                    if (dictionary.size() > window_size)
+                    {
+                        dictionary = dictionary.substr(
+                            dictionary.size() - window_size);
+                    }
+                }
+                checksums[i] = adler32(
+                    adler32(0, nullptr, 0),
+                    input.get<const u8>(),
+                    input.size());
+                band_sizes[i] = input.size();
+                bands[i] = deflate_band(
+                    input, dictionary, settings, i == band_count - 1);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    // bands go to idle pool threads, if any; the rest are done here
+    {
+        const algo::HelpRequest help_request(work, band_count - 1);
+        work();
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    auto checksum = checksums[0];
+    for (const auto i : algo::range(1, band_count))
+        checksum = adler32_combine(checksum, checksums[i], band_sizes[i]);
+
+    io::MemoryByteStream header_stream;
+    header_stream.write_be<u32>(width);
+    header_stream.write_be<u32>(height);
+    header_stream.write<u8>(8); // bit depth
+    header_stream.write<u8>(PNG_COLOR_TYPE_RGBA);
+    header_stream.write<u8>(PNG_COMPRESSION_TYPE_BASE);
+    header_stream.write<u8>(PNG_FILTER_TYPE_BASE);
+    header_stream.write<u8>(PNG_INTERLACE_NONE);
+
+    // zlib header: 32K window, deflate, FLEVEL matching the level
+    const auto level = settings.compression_level;
+    io::MemoryByteStream zlib_header_stream;
+    zlib_header_stream.write<u8>(0x78);
+    zlib_header_stream.write<u8>(level <= 1 ? 0x01 : level < 9 ? 0x9C : 0xDA);
+    bands.front() = zlib_header_stream.seek(0).read_to_eof() + bands.front();
+    io::MemoryByteStream trailer_stream;
+    trailer_stream.write_be<u32>(checksum);
+    bands.back() += trailer_stream.seek(0).read_to_eof();
+
+    output_stream.write(png_magic);
+    write_chunk(output_stream, "IHDR"_b, header_stream.seek(0).read_to_eof());
+    for (const auto &band : bands)
+        write_chunk(output_stream, "IDAT"_b, band);
+    write_chunk(output_stream, "IEND"_b, ""_b);
+}
+
 static void write_handler(
     png_structp png_ptr, png_bytep input, png_size_t size)
 {
@@ -36,11 +392,34 @@ static void flush_handler(png_structp)
 {
 }
 
+PngImageEncoder::PngImageEncoder(const PngEncodeProfile profile) :
+        profile(profile)
+{
+}
+
 void PngImageEncoder::encode_impl(
     const Logger &logger,
     const res::Image &input_image,
     io::File &output_file) const
 {
+    const auto width = input_image.width();
+    const auto height = input_image.height();
+    if (!width || !height)
+        throw err::BadDataSizeError();
+
+    auto settings = get_profile_settings(profile);
+    if (settings.adaptive_filtering)
+        settings.adaptive_filtering = is_filtering_worthwhile(input_image);
+    const auto rows_per_band
+        = std::max<size_t>(1, band_size / (1 + width * 4));
+    if (height > rows_per_band)
+    {
+        encode_in_bands(
+            input_image, settings, rows_per_band, output_file.stream);
+        output_file.path.change_extension("png");
+        return;
+    }
+
     png_structp png_ptr = png_create_write_struct(
         PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     if (!png_ptr)
@@ -50,11 +429,6 @@ void PngImageEncoder::encode_impl(
     if (!info_ptr)
         throw std::logic_error("Failed to create PNG info structure");
 
-    const auto width = input_image.width();
-    const auto height = input_image.height();
-    if (!width || !height)
-        throw err::BadDataSizeError();
-    const auto bpp = 4;
     const auto color_type = PNG_COLOR_TYPE_RGBA;
     int transformations = PNG_TRANSFORM_BGR;
 
@@ -64,10 +438,11 @@ void PngImageEncoder::encode_impl(
         PNG_COMPRESSION_TYPE_BASE,
         PNG_FILTER_TYPE_BASE);
 
-    // 0 = no compression, 9 = max compression
-    // 1 produces good file size and is still fast.
-    png_set_filter(png_ptr, 0, PNG_FILTER_NONE);
-    png_set_compression_level(png_ptr, 1);
+    png_set_filter(
+        png_ptr,
+        0,
+        settings.adaptive_filtering ? PNG_ALL_FILTERS : PNG_FILTER_NONE);
+    png_set_compression_level(png_ptr, settings.compression_level);
 
     png_set_write_fn(
         png_ptr, &output_file.stream, &write_handler, &flush_handler);
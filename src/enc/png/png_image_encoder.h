@@ -14,7 +14,6 @@
 //
 // You should have received a copy of the GNU General Public License
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
-
 #pragma once
 
 #include "enc/base_image_encoder.h"
@@ -23,13 +22,29 @@ namespace au {
 namespace enc {
 namespace png {
 
+    // Trades output size for encoding speed.
+    enum class PngEncodeProfile : u8
+    {
+        Store,    // no filtering, no compression
+        Fast,     // no filtering, zlib level 1
+        Balanced, // adaptive filtering, zlib level 6
+        Small,    // adaptive filtering, zlib level 9
+    };
+
     class PngImageEncoder final : public BaseImageEncoder
     {
+    public:
+        PngImageEncoder(
+            const PngEncodeProfile profile = PngEncodeProfile::Fast);
+
     protected:
         void encode_impl(
             const Logger &logger,
             const res::Image &input_image,
             io::File &output_file) const override;
+
+    private:
+        const PngEncodeProfile profile;
     };
 
 } } }
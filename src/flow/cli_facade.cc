@@ -17,14 +17,20 @@
 
 #include "flow/cli_facade.h"
 #include <algorithm>
+#include <cctype>
+#include <limits>
 #include <map>
 #include "algo/range.h"
 #include "algo/str.h"
 #include "arg_parser.h"
 #include "dec/idecoder.h"
 #include "dec/registry.h"
+#include "enc/image_encoder_registry.h"
+#include "err.h"
 #include "flow/file_saver_hdd.h"
+#include "flow/file_saver_tar.h"
 #include "flow/parallel_unpacker.h"
+#include "io/file.h"
 #include "io/file_system.h"
 #include "version.h"
 #include "virtual_file_system.h"
@@ -47,9 +53,48 @@ namespace
         bool should_list_decoders;
         int verbosity = 3;
         unsigned int thread_count;
+        uoff_t max_memory;
+        io::path trace_path;
+        io::path tar_path;
+        std::string image_format;
     };
 }
 
+static uoff_t parse_size(const std::string &input)
+{
+    uoff_t multiplier = 1;
+    auto number = input;
+    if (!number.empty())
+    {
+        switch (std::toupper(number.back()))
+        {
+            case 'K': multiplier = 1024; break;
+            case 'M': multiplier = 1024 * 1024; break;
+            case 'G': multiplier = 1024 * 1024 * 1024; break;
+        }
+    }
+    if (multiplier != 1)
+        number.pop_back();
+
+    const auto max_size = std::numeric_limits<uoff_t>::max();
+    if (number.empty()
+        || number.find_first_not_of("0123456789") != std::string::npos)
+    {
+        throw err::UsageError("Invalid size: \"" + input + "\"");
+    }
+    uoff_t size = 0;
+    for (const auto c : number)
+    {
+        const uoff_t digit = c - '0';
+        if (size > (max_size - digit) / 10)
+            throw err::UsageError("Size is too large: \"" + input + "\"");
+        size = size * 10 + digit;
+    }
+    if (size > max_size / multiplier)
+        throw err::UsageError("Size is too large: \"" + input + "\"");
+    return size * multiplier;
+}
+
 struct CliFacade::Priv final
 {
 public:
@@ -97,6 +142,18 @@ CliFacade::Priv::Priv(Logger &logger, const std::vector<std::string> &arguments)
     {
         logger.mute(Logger::MessageType::Info);
     }
+
+    // the standard output is taken by the archive; errors and warnings go
+    // to the standard error and can stay, but without colors, which may be
+    // written to the standard output regardless of the message type
+    if (options.tar_path.str() == "-")
+    {
+        logger.mute(Logger::MessageType::Summary);
+        logger.mute(Logger::MessageType::Success);
+        logger.mute(Logger::MessageType::Info);
+        logger.mute(Logger::MessageType::Debug);
+        logger.disable_colors();
+    }
 }
 
 void CliFacade::Priv::print_decoder_list() const
@@ -179,6 +236,39 @@ void CliFacade::Priv::register_cli_options()
         ->set_value_name("NUM")
         ->set_description("Sets worker thread count.");
 
+    arg_parser.register_switch({"--max-memory"})
+        ->set_value_name("SIZE")
+        ->set_description(
+            "Limits how much decoded data can be kept in memory at once. "
+            "When the limit is reached, extracting further files is held "
+            "back until memory is freed. SIZE accepts K, M and G suffixes. "
+            "By default, memory usage is unlimited.");
+
+    arg_parser.register_switch({"--tar"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Writes all output files into a single tar archive FILE instead "
+            "of creating them in the output directory. Use - to write to "
+            "the standard output.");
+
+    {
+        auto sw = arg_parser.register_switch({"--image-format"})
+            ->set_value_name("FORMAT")
+            ->set_description(
+                "Selects how decoded images are saved (defaults to png). "
+                "png-store and bmp skip compression altogether; pam stores "
+                "raw RGBA samples behind a short text header, which suits "
+                "output that gets re-encoded by another tool anyway.");
+        for (const auto &name : enc::get_image_encoder_names())
+            sw->add_possible_value(name);
+    }
+
+    arg_parser.register_switch({"--trace"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Saves timings of recognition, decoding, encoding and saving "
+            "of each file to FILE in Chrome trace event format.");
+
     {
         auto sw = arg_parser.register_switch({"-v", "--verbosity"})
             ->set_description(
@@ -244,6 +334,20 @@ void CliFacade::Priv::parse_cli_options()
     else
         options.thread_count = 0;
 
+    options.max_memory = arg_parser.has_switch("--max-memory")
+        ? parse_size(arg_parser.get_switch("--max-memory"))
+        : 0;
+
+    if (arg_parser.has_switch("--trace"))
+        options.trace_path = arg_parser.get_switch("--trace");
+
+    if (arg_parser.has_switch("--tar"))
+        options.tar_path = arg_parser.get_switch("--tar");
+
+    options.image_format = arg_parser.has_switch("--image-format")
+        ? arg_parser.get_switch("--image-format")
+        : "png";
+
     if (arg_parser.has_flag("--no-vfs"))
         VirtualFileSystem::disable();
 
@@ -306,14 +410,33 @@ int CliFacade::Priv::run() const
         ? std::set<std::string>(name_list.begin(), name_list.end())
         : std::set<std::string>{options.decoder};
 
-    FileSaverHdd file_saver(options.output_dir, options.overwrite);
+    const auto image_encoder = enc::create_image_encoder(options.image_format);
+
+    // mapped inputs must not be truncated, which outputs replacing existing
+    // files could do
+    const auto outputs_can_replace_inputs = options.tar_path.str().empty()
+        ? options.overwrite
+        : options.tar_path.str() != "-" && io::exists(options.tar_path);
+    io::set_file_mapping_enabled(!outputs_can_replace_inputs);
+
+    std::unique_ptr<IFileSaver> file_saver;
+    if (options.tar_path.str().empty())
+    {
+        file_saver.reset(
+            new FileSaverHdd(options.output_dir, options.overwrite));
+    }
+    else
+        file_saver.reset(new FileSaverTar(options.tar_path));
     ParallelUnpackerContext context(
         logger,
-        file_saver,
+        *file_saver,
         registry,
+        *image_encoder,
         options.enable_nested_decoding,
         arguments,
-        available_decoders);
+        available_decoders,
+        options.max_memory,
+        options.trace_path);
 
     ParallelUnpacker unpacker(context);
     for (const auto &input_path : options.input_paths)
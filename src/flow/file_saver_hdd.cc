@@ -16,10 +16,12 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/file_saver_hdd.h"
+#include <atomic>
 #include <mutex>
 #include <set>
 #include "algo/format.h"
 #include "io/file_byte_stream.h"
+#include "io/file_range.h"
 #include "io/file_system.h"
 
 using namespace au;
@@ -34,10 +36,11 @@ struct FileSaverHdd::Priv final
         const bool overwrite);
 
     io::path make_path_unique(const io::path &path);
+    std::unique_ptr<io::FileByteStream> open(const io::path &path) const;
 
     io::path output_dir;
     bool overwrite;
-    size_t saved_file_count;
+    std::atomic<size_t> saved_file_count;
     std::set<io::path> paths;
 };
 
@@ -59,6 +62,13 @@ io::path FileSaverHdd::Priv::make_path_unique(const io::path &path)
     return new_path;
 }
 
+std::unique_ptr<io::FileByteStream> FileSaverHdd::Priv::open(
+    const io::path &path) const
+{
+    io::create_directories(path.parent());
+    return std::make_unique<io::FileByteStream>(path, io::FileMode::Write);
+}
+
 FileSaverHdd::FileSaverHdd(
     const io::path &output_dir, const bool overwrite)
     : p(new Priv(output_dir, overwrite))
@@ -71,12 +81,33 @@ FileSaverHdd::~FileSaverHdd()
 
 io::path FileSaverHdd::save(std::shared_ptr<io::File> file) const
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    const auto full_path = p->make_path_unique(p->output_dir / file->path);
-    io::create_directories(full_path.parent());
-    io::FileByteStream output_stream(full_path, io::FileMode::Write);
-    file->stream.seek(0);
-    output_stream.write(file->stream);
+    // Only the name reservation is serialized; the data is written outside
+    // the lock so that multiple outputs can be written concurrently.
+    io::path full_path;
+    std::unique_ptr<io::FileByteStream> output_stream;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        full_path = p->make_path_unique(p->output_dir / file->path);
+        // without overwriting, other savers probe the disk to find free
+        // names, so the file must exist before the lock is released
+        if (!p->overwrite)
+            output_stream = p->open(full_path);
+    }
+    io::FileRange range;
+    if (file->stream.get_file_range(range))
+    {
+        // entries stored verbatim in the archive are copied disk to disk
+        output_stream.reset();
+        io::create_directories(full_path.parent());
+        io::copy_file_range(range, full_path);
+    }
+    else
+    {
+        if (!output_stream)
+            output_stream = p->open(full_path);
+        file->stream.seek(0);
+        output_stream->write(file->stream);
+    }
     ++p->saved_file_count;
     return full_path;
 }
@@ -0,0 +1,276 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_tar.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <set>
+#include "algo/format.h"
+#include "err.h"
+#include "io/file_byte_stream.h"
+
+#if _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+using namespace au;
+using namespace au::flow;
+
+static const size_t block_size = 512;
+static const size_t copy_buffer_size = 64 * 1024;
+
+namespace
+{
+    struct TarHeader final
+    {
+        char name[100];
+        char mode[8];
+        char uid[8];
+        char gid[8];
+        char size[12];
+        char mtime[12];
+        char checksum[8];
+        char type;
+        char link_name[100];
+        char magic[6];
+        char version[2];
+        char user_name[32];
+        char group_name[32];
+        char dev_major[8];
+        char dev_minor[8];
+        char prefix[155];
+        char padding[12];
+    };
+
+    static_assert(sizeof(TarHeader) == block_size, "Bad tar header size");
+}
+
+static void write_octal(char *target, const size_t target_size, u64 value)
+{
+    // the last byte stays a terminator
+    for (auto i = target_size - 1; i-- > 0; )
+    {
+        target[i] = '0' + (value & 7);
+        value >>= 3;
+    }
+}
+
+static void write_number(char *target, const size_t target_size, u64 value)
+{
+    if (value < (1ull << (3 * (target_size - 1))))
+    {
+        write_octal(target, target_size, value);
+        return;
+    }
+    // GNU base-256 extension for sizes that don't fit in octal
+    for (auto i = target_size; i-- > 1; )
+    {
+        target[i] = static_cast<char>(value & 0xFF);
+        value >>= 8;
+    }
+    target[0] = static_cast<char>(0x80);
+}
+
+static bstr make_header(
+    const std::string &name, const char type, const uoff_t size)
+{
+    bstr ret(block_size);
+    auto &header = *ret.get<TarHeader>();
+    std::memcpy(
+        header.name, name.c_str(), std::min(name.size(), sizeof(header.name)));
+    write_octal(header.mode, sizeof(header.mode), 0644);
+    write_octal(header.uid, sizeof(header.uid), 0);
+    write_octal(header.gid, sizeof(header.gid), 0);
+    write_number(header.size, sizeof(header.size), size);
+    write_octal(header.mtime, sizeof(header.mtime), std::time(nullptr));
+    header.type = type;
+    std::memcpy(header.magic, "ustar ", 6);
+    std::memcpy(header.version, " ", 2);
+
+    std::memset(header.checksum, ' ', sizeof(header.checksum));
+    u32 checksum = 0;
+    for (const auto c : ret)
+        checksum += c;
+    write_octal(header.checksum, sizeof(header.checksum) - 1, checksum);
+    header.checksum[sizeof(header.checksum) - 2] = '\0';
+    return ret;
+}
+
+static bstr make_padding(const uoff_t size)
+{
+    return bstr((block_size - size % block_size) % block_size);
+}
+
+struct FileSaverTar::Priv final
+{
+    Priv(const io::path &output_path);
+    ~Priv();
+
+    std::string make_name_unique(const io::path &path);
+    void write(const bstr &data);
+    void write(io::BaseByteStream &input_stream, const uoff_t size);
+
+    std::mutex mutex;
+    std::unique_ptr<io::FileByteStream> output_stream;
+    std::set<std::string> names;
+    std::atomic<size_t> saved_file_count;
+};
+
+FileSaverTar::Priv::Priv(const io::path &output_path) : saved_file_count(0)
+{
+    if (output_path.str() == "-")
+    {
+        #if _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+        #endif
+    }
+    else
+    {
+        output_stream = std::make_unique<io::FileByteStream>(
+            output_path, io::FileMode::Write);
+    }
+}
+
+FileSaverTar::Priv::~Priv()
+{
+    // end of archive marker
+    try
+    {
+        write(bstr(block_size * 2));
+    }
+    catch (...)
+    {
+    }
+    if (!output_stream)
+        std::fflush(stdout);
+}
+
+static std::string get_member_name(const io::path &path)
+{
+    auto name = path.str();
+    std::replace(name.begin(), name.end(), '\\', '/');
+    return name;
+}
+
+std::string FileSaverTar::Priv::make_name_unique(const io::path &path)
+{
+    // separators are normalized before comparing, so that paths differing
+    // only in them don't end up as the same member
+    auto new_path = path;
+    auto name = get_member_name(new_path);
+    int i = 1;
+    while (names.find(name) != names.end())
+    {
+        new_path.change_stem(path.stem() + algo::format("(%d)", i++));
+        name = get_member_name(new_path);
+    }
+    names.insert(name);
+    return name;
+}
+
+void FileSaverTar::Priv::write(const bstr &data)
+{
+    if (data.empty())
+        return;
+    if (output_stream)
+    {
+        output_stream->write(data);
+        return;
+    }
+    if (std::fwrite(data.get<const u8>(), 1, data.size(), stdout)
+        != data.size())
+    {
+        throw err::IoError("Could not write full data");
+    }
+}
+
+void FileSaverTar::Priv::write(
+    io::BaseByteStream &input_stream, const uoff_t size)
+{
+    uoff_t written = 0;
+    try
+    {
+        input_stream.seek(0);
+        while (written < size)
+        {
+            const auto chunk = input_stream.read(
+                std::min<uoff_t>(copy_buffer_size, size - written));
+            write(chunk);
+            written += chunk.size();
+        }
+    }
+    catch (...)
+    {
+        // the header already declares the full size; fill the rest with
+        // zeros so that the members that follow stay aligned
+        try
+        {
+            while (written < size)
+            {
+                const auto chunk_size
+                    = std::min<uoff_t>(copy_buffer_size, size - written);
+                write(bstr(chunk_size));
+                written += chunk_size;
+            }
+            write(make_padding(size));
+        }
+        catch (...)
+        {
+        }
+        throw;
+    }
+    write(make_padding(size));
+}
+
+FileSaverTar::FileSaverTar(const io::path &output_path)
+    : p(new Priv(output_path))
+{
+}
+
+FileSaverTar::~FileSaverTar()
+{
+}
+
+io::path FileSaverTar::save(std::shared_ptr<io::File> file) const
+{
+    // tar members have no alignment other than the block size, so entries
+    // are written whole, one at a time
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto name = p->make_name_unique(file->path);
+    const auto size = file->stream.size();
+    if (name.size() >= sizeof(TarHeader::name))
+    {
+        // GNU extension: the real name is stored as a preceding pseudo-file
+        p->write(make_header("././@LongLink", 'L', name.size() + 1));
+        p->write(bstr(name.c_str(), name.size() + 1));
+        p->write(make_padding(name.size() + 1));
+    }
+    p->write(make_header(name, '0', size));
+    p->write(file->stream, size);
+    ++p->saved_file_count;
+    return name;
+}
+
+size_t FileSaverTar::get_saved_file_count() const
+{
+    return p->saved_file_count;
+}
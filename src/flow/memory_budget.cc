@@ -0,0 +1,128 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/memory_budget.h"
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include "io/memory_byte_stream.h"
+#include "io/slice_byte_stream.h"
+
+using namespace au;
+using namespace au::flow;
+
+struct MemoryBudget::Priv final
+{
+    Priv(const uoff_t limit);
+    void acquire(const u8 *buffer, const uoff_t size);
+    void release(const u8 *buffer);
+
+    const uoff_t limit;
+    uoff_t used;
+    size_t waiting_count;
+    std::map<const u8*, std::pair<uoff_t, size_t>> buffers;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+MemoryBudget::Priv::Priv(const uoff_t limit)
+    : limit(limit), used(0), waiting_count(0)
+{
+}
+
+void MemoryBudget::Priv::acquire(const u8 *buffer, const uoff_t size)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto &entry = buffers[buffer];
+    if (!entry.second++)
+    {
+        entry.first = size;
+        used += size;
+    }
+}
+
+void MemoryBudget::Priv::release(const u8 *buffer)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto it = buffers.find(buffer);
+        if (--it->second.second)
+            return;
+        used -= it->second.first;
+        buffers.erase(it);
+    }
+    cv.notify_all();
+}
+
+MemoryBudget::MemoryBudget(const uoff_t limit)
+    : p(std::make_shared<Priv>(limit))
+{
+}
+
+MemoryBudget::~MemoryBudget()
+{
+}
+
+void MemoryBudget::wait(const size_t worker_count) const
+{
+    if (!p->limit)
+        return;
+    std::unique_lock<std::mutex> lock(p->mutex);
+    ++p->waiting_count;
+    p->cv.wait(lock, [&]()
+    {
+        return p->used < p->limit || p->waiting_count >= worker_count;
+    });
+    --p->waiting_count;
+}
+
+std::shared_ptr<io::File> MemoryBudget::track(
+    const std::shared_ptr<io::File> file) const
+{
+    if (!p->limit || !file)
+        return file;
+
+    // slices keep their parent alive, so they are charged for all of it
+    const io::BaseByteStream *stream = &file->stream;
+    const auto slice = dynamic_cast<const io::SliceByteStream*>(stream);
+    if (slice)
+        stream = &slice->get_parent_stream();
+
+    // files that read their data on demand hold next to nothing in memory
+    if (!dynamic_cast<const io::MemoryByteStream*>(stream))
+        return file;
+
+    // files sharing one buffer, such as slices of one archive, count it once
+    const auto size = stream->size();
+    const auto buffer = stream->get_view(0, size);
+    p->acquire(buffer, size);
+
+    // the budget may be gone by the time the last copy of the file dies
+    const auto priv = p;
+    return std::shared_ptr<io::File>(
+        file.get(),
+        [priv, file, buffer](io::File *)
+        {
+            priv->release(buffer);
+        });
+}
+
+uoff_t MemoryBudget::get_used() const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    return p->used;
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include "io/file.h"
+
+namespace au {
+namespace flow {
+
+    // Keeps track of the bytes held by decoded files that are still being
+    // processed, and lets the workers wait until enough of them are freed.
+    class MemoryBudget final
+    {
+    public:
+        MemoryBudget(const uoff_t limit);
+        ~MemoryBudget();
+
+        // Blocks while the budget is exhausted. To guarantee progress, the
+        // last of worker_count workers never waits.
+        void wait(const size_t worker_count) const;
+
+        // Returns a file that releases its bytes from the budget once all of
+        // its copies are destroyed. Only files held in memory are counted;
+        // slices of such files are charged for the buffer they keep alive.
+        std::shared_ptr<io::File> track(
+            const std::shared_ptr<io::File> file) const;
+
+        uoff_t get_used() const;
+
+    private:
+        struct Priv;
+        std::shared_ptr<Priv> p;
+    };
+
+} }
@@ -16,18 +16,44 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/parallel_decoder_adapter.h"
+#include <algorithm>
+#include "algo/range.h"
 #include "algo/naming_strategies.h"
 #include "enc/microsoft/wav_audio_encoder.h"
-#include "enc/png/png_image_encoder.h"
+#include "flow/trace_recorder.h"
 #include "flow/vfs_bridge.h"
 
 using namespace au;
 using namespace au::flow;
 
+static const uoff_t prefetch_window_size = 4 * 1024 * 1024;
+
+static bool get_entry_offset(const dec::ArchiveEntry &entry, uoff_t &offset)
+{
+    const auto plain_entry
+        = dynamic_cast<const dec::PlainArchiveEntry*>(&entry);
+    if (plain_entry)
+    {
+        offset = plain_entry->offset;
+        return true;
+    }
+    const auto compressed_entry
+        = dynamic_cast<const dec::CompressedArchiveEntry*>(&entry);
+    if (compressed_entry)
+    {
+        offset = compressed_entry->offset;
+        return true;
+    }
+    return false;
+}
+
 ParallelDecoderAdapter::ParallelDecoderAdapter(
     const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
-    const std::shared_ptr<io::File> input_file)
-    : parent_task(parent_task), input_file(input_file)
+    const std::shared_ptr<io::File> input_file,
+    const std::string &decoder_name) :
+        parent_task(parent_task),
+        input_file(input_file),
+        decoder_name(decoder_name)
 {
 }
 
@@ -38,8 +64,15 @@ ParallelDecoderAdapter::~ParallelDecoderAdapter()
 void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
 {
     auto input_file = this->input_file;
-    auto meta = std::shared_ptr<dec::ArchiveMeta>(
-        decoder.read_meta(parent_task->logger, *input_file));
+    const auto decoder_name = this->decoder_name;
+    const auto trace_recorder = &parent_task->task_context.trace_recorder;
+    std::shared_ptr<dec::ArchiveMeta> meta;
+    {
+        TraceSpan span(
+            *trace_recorder, "read_meta", decoder_name, input_file->path.str());
+        meta = std::shared_ptr<dec::ArchiveMeta>(
+            decoder.read_meta(parent_task->logger, *input_file));
+    }
     parent_task->logger.info(
         "archive contains %d files.\n", meta->entries.size());
 
@@ -50,54 +83,125 @@ void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
         input_file,
         parent_task->base_name);
 
-    for (const auto &entry : meta->entries)
+    // Entries are queued by their offset in the archive so that the worker
+    // that owns them reads the archive front to back, while idle workers
+    // steal from the other end. Each worker thus reads a contiguous run, and
+    // the range following each entry is announced to the kernel in advance.
+    const auto entry_count = meta->entries.size();
+    std::vector<uoff_t> offsets(entry_count);
+    std::vector<bool> has_offset(entry_count);
+    for (const auto i : algo::range(entry_count))
+        has_offset[i] = get_entry_offset(*meta->entries[i], offsets[i]);
+    std::vector<size_t> order(entry_count);
+    for (const auto i : algo::range(entry_count))
+        order[i] = i;
+    std::stable_sort(
+        order.begin(),
+        order.end(),
+        [&](const size_t a, const size_t b) -> bool
+        {
+            if (has_offset[a] != has_offset[b])
+                return has_offset[a];
+            return has_offset[a] && offsets[a] < offsets[b];
+        });
+
+    for (auto k = entry_count; k-- > 0; )
     {
+        const auto entry = meta->entries[order[k]].get();
+        uoff_t prefetch_offset = 0, prefetch_size = 0;
+        if (k + 1 < entry_count && has_offset[order[k + 1]])
+        {
+            prefetch_offset = offsets[order[k + 1]];
+            prefetch_size = prefetch_window_size;
+        }
         parent_task->save_file(
             input_file,
-            [meta, &entry, &decoder, vfs_bridge]
+            [meta, entry, &decoder, vfs_bridge, trace_recorder, decoder_name,
+                prefetch_offset, prefetch_size]
             (io::File &input_file_copy, const Logger &logger)
             {
+                TraceSpan span(
+                    *trace_recorder,
+                    "read_file",
+                    decoder_name,
+                    entry->path.str());
+                if (prefetch_size)
+                {
+                    input_file_copy.stream.prefetch(
+                        prefetch_offset, prefetch_size);
+                }
                 return decoder.read_file(
                     logger, input_file_copy, *meta, *entry);
             },
             decoder,
+            decoder_name,
             entry->path.str());
     }
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseFileDecoder &decoder)
 {
+    const auto decoder_name = this->decoder_name;
+    const auto trace_recorder = &parent_task->task_context.trace_recorder;
     parent_task->save_file(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, trace_recorder, decoder_name]
+        (io::File &input_file_copy, const Logger &logger)
         {
+            TraceSpan span(
+                *trace_recorder,
+                "decode",
+                decoder_name,
+                input_file_copy.path.str());
             return decoder.decode(logger, input_file_copy);
         },
-        decoder);
+        decoder,
+        decoder_name);
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseImageDecoder &decoder)
 {
+    const auto decoder_name = this->decoder_name;
+    const auto trace_recorder = &parent_task->task_context.trace_recorder;
+    const auto encoder
+        = &parent_task->task_context.unpacker_context.image_encoder;
     parent_task->save_file(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, trace_recorder, encoder, decoder_name]
+        (io::File &input_file_copy, const Logger &logger)
         {
+            const auto file_name = input_file_copy.path.str();
+            std::unique_ptr<TraceSpan> span(new TraceSpan(
+                *trace_recorder, "decode", decoder_name, file_name));
             auto output_file = decoder.decode(logger, input_file_copy);
-            const auto encoder = enc::png::PngImageEncoder();
-            return encoder.encode(logger, output_file, input_file_copy.path);
+            span.reset();
+            span.reset(new TraceSpan(
+                *trace_recorder, "encode", decoder_name, file_name));
+            return encoder->encode(logger, output_file, input_file_copy.path);
         },
-        decoder);
+        decoder,
+        decoder_name);
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseAudioDecoder &decoder)
 {
+    const auto decoder_name = this->decoder_name;
+    const auto trace_recorder = &parent_task->task_context.trace_recorder;
     parent_task->save_file(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, trace_recorder, decoder_name]
+        (io::File &input_file_copy, const Logger &logger)
         {
+            const auto file_name = input_file_copy.path.str();
+            std::unique_ptr<TraceSpan> span(new TraceSpan(
+                *trace_recorder, "decode", decoder_name, file_name));
             auto output_file = decoder.decode(logger, input_file_copy);
+            span.reset();
+            span.reset(new TraceSpan(
+                *trace_recorder, "encode", decoder_name, file_name));
             const auto encoder = enc::microsoft::WavAudioEncoder();
             return encoder.encode(logger, output_file, input_file_copy.path);
         },
-        decoder);
+        decoder,
+        decoder_name);
 }
@@ -17,12 +17,15 @@
 
 #include "flow/parallel_unpacker.h"
 #include <chrono>
+#include <mutex>
 #include <set>
 #include <stack>
 #include "algo/format.h"
+#include "arena.h"
 #include "dec/idecoder.h"
 #include "err.h"
 #include "flow/parallel_decoder_adapter.h"
+#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::flow;
@@ -59,6 +62,7 @@ namespace
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory file_factory,
             const std::shared_ptr<const dec::IDecoder> origin_decoder,
+            const std::string &origin_decoder_name,
             const std::string &target_name);
 
         bool work() const override;
@@ -66,13 +70,21 @@ namespace
         const std::shared_ptr<io::File> input_file;
         const DecoderFileFactory file_factory;
         const std::shared_ptr<const dec::IDecoder> origin_decoder;
+        const std::string origin_decoder_name;
         const std::string target_name;
     };
 }
 
 static bool save(
-    const BaseParallelUnpackingTask &task, std::shared_ptr<io::File> file)
+    const BaseParallelUnpackingTask &task,
+    std::shared_ptr<io::File> file,
+    const std::string &decoder_name)
 {
+    TraceSpan span(
+        task.task_context.trace_recorder,
+        "save",
+        decoder_name,
+        file->path.str());
     try
     {
         const auto full_path
@@ -90,11 +102,28 @@ static bool save(
     }
 }
 
+// Decoded files outlive the task that made them, and a buffer left in its
+// arena would keep the whole block alive. Buffers small enough to come from
+// an arena are therefore copied to the heap once the arena is no longer in
+// use; larger ones were never served by it.
+static std::shared_ptr<io::File> move_out_of_arena(
+    const std::shared_ptr<io::File> file)
+{
+    if (!file
+        || !dynamic_cast<const io::MemoryByteStream*>(&file->stream)
+        || file->stream.size() > Arena::max_allocation_size)
+    {
+        return file;
+    }
+    file->stream.seek(0);
+    return std::make_shared<io::File>(file->path, file->stream.read_to_eof());
+}
+
 static std::set<std::string> collect_linked_decoders(
     const dec::IDecoder &base_decoder, const dec::Registry &registry)
 {
     std::set<std::string> known_formats;
-    std::vector<std::shared_ptr<dec::IDecoder>> linked_decoders;
+    std::vector<std::shared_ptr<const dec::IDecoder>> linked_decoders;
     std::stack<const dec::IDecoder*> decoders_to_inspect;
     decoders_to_inspect.push(&base_decoder);
     while (!decoders_to_inspect.empty())
@@ -106,7 +135,7 @@ static std::set<std::string> collect_linked_decoders(
             if (known_formats.find(format) != known_formats.end())
                 continue;
             known_formats.insert(format);
-            auto linked_decoder = registry.create_decoder(format);
+            auto linked_decoder = registry.get_decoder_prototype(format);
             decoders_to_inspect.push(linked_decoder.get());
             linked_decoders.push_back(std::move(linked_decoder));
         }
@@ -114,7 +143,7 @@ static std::set<std::string> collect_linked_decoders(
     return std::set<std::string>(known_formats.begin(), known_formats.end());
 }
 
-static std::shared_ptr<dec::IDecoder> guess_decoder(
+static std::string guess_decoder(
     const BaseParallelUnpackingTask &task,
     const std::set<std::string> &decoders_to_check,
     io::File &file,
@@ -123,20 +152,22 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
     task.logger.info(
         "guessing decoder among %d decoders...\n", decoders_to_check.size());
 
-    std::map<std::string, std::shared_ptr<dec::IDecoder>> matching_decoders;
-    for (const auto &name : decoders_to_check)
+    const auto &registry = task.task_context.unpacker_context.registry;
+    const auto candidate_names
+        = registry.get_candidate_decoder_names(decoders_to_check, file);
+
+    std::set<std::string> matching_decoders;
+    for (const auto &name : candidate_names)
     {
-        const auto current_decoder
-            = task.task_context.unpacker_context.registry.create_decoder(name);
-        if (current_decoder->is_recognized(file))
-            matching_decoders[name] = std::move(current_decoder);
+        if (registry.get_decoder_prototype(name)->is_recognized(file))
+            matching_decoders.insert(name);
     }
 
     if (matching_decoders.size() == 1)
     {
         task.logger.success(
-            "recognized as %s.\n", matching_decoders.begin()->first.c_str());
-        return matching_decoders.begin()->second;
+            "recognized as %s.\n", matching_decoders.begin()->c_str());
+        return *matching_decoders.begin();
     }
 
     if (matching_decoders.empty())
@@ -149,7 +180,7 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
         {
             task.logger.err("not recognized by any decoder.\n");
         }
-        return nullptr;
+        return "";
     }
 
     if (source_type == TaskSourceType::NestedDecoding)
@@ -159,26 +190,32 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
     else
     {
         task.logger.warn("file was recognized by multiple decoders.\n");
-        for (const auto &it : matching_decoders)
-            task.logger.warn("- " + it.first + "\n");
+        for (const auto &name : matching_decoders)
+            task.logger.warn("- " + name + "\n");
         task.logger.warn("Please provide --dec and proceed manually.\n");
     }
-    return nullptr;
+    return "";
 }
 
 ParallelUnpackerContext::ParallelUnpackerContext(
     const Logger &logger,
     const IFileSaver &file_saver,
     const dec::Registry &registry,
+    const enc::BaseImageEncoder &image_encoder,
     const bool enable_nested_decoding,
     const std::vector<std::string> &arguments,
-    const std::set<std::string> &decoders_to_check) :
+    const std::set<std::string> &decoders_to_check,
+    const uoff_t max_memory,
+    const io::path &trace_path) :
         logger(logger),
         file_saver(file_saver),
         registry(registry),
+        image_encoder(image_encoder),
         enable_nested_decoding(enable_nested_decoding),
         arguments(arguments),
-        decoders_to_check(decoders_to_check)
+        decoders_to_check(decoders_to_check),
+        max_memory(max_memory),
+        trace_path(trace_path)
 {
 }
 
@@ -188,10 +225,35 @@ ParallelTaskContext::ParallelTaskContext(
     TaskScheduler &task_scheduler) :
         unpacker(unpacker),
         unpacker_context(unpacker_context),
-        task_scheduler(task_scheduler)
+        task_scheduler(task_scheduler),
+        memory_budget(unpacker_context.max_memory),
+        trace_recorder(!unpacker_context.trace_path.str().empty())
 {
 }
 
+std::shared_ptr<const dec::IDecoder>
+    ParallelTaskContext::get_configured_decoder(const std::string &name)
+{
+    {
+        std::unique_lock<std::mutex> lock(configured_decoders_mutex);
+        const auto it = configured_decoders.find(name);
+        if (it != configured_decoders.end())
+            return it->second;
+    }
+
+    const auto decoder = unpacker_context.registry.create_decoder(name);
+    ArgParser decoder_arg_parser;
+    const auto decorators = decoder->get_arg_parser_decorators();
+    for (const auto &decorator : decorators)
+        decorator.register_cli_options(decoder_arg_parser);
+    decoder_arg_parser.parse(unpacker_context.arguments);
+    for (const auto &decorator : decorators)
+        decorator.parse_cli_options(decoder_arg_parser);
+
+    std::unique_lock<std::mutex> lock(configured_decoders_mutex);
+    return configured_decoders.insert({name, decoder}).first->second;
+}
+
 BaseParallelUnpackingTask::BaseParallelUnpackingTask(
     ParallelTaskContext &task_context,
     const TaskSourceType source_type,
@@ -228,6 +290,7 @@ void BaseParallelUnpackingTask::save_file(
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
     const dec::BaseDecoder &origin_decoder,
+    const std::string &origin_decoder_name,
     const std::string &target_name) const
 {
     task_context.task_scheduler.push_front(
@@ -241,6 +304,7 @@ void BaseParallelUnpackingTask::save_file(
             input_file,
             file_factory,
             origin_decoder.shared_from_this(),
+            origin_decoder_name,
             target_name));
 }
 
@@ -283,25 +347,28 @@ bool DecodeInputFileTask::work() const
     {
         logger.info("initial recognition...\n");
 
-        const auto decoder = guess_decoder(
-            *this, decoders_to_check, *input_file, source_type);
+        std::string decoder_name;
+        {
+            TraceSpan span(
+                task_context.trace_recorder,
+                "recognition",
+                "",
+                input_file->path.str());
+            decoder_name = guess_decoder(
+                *this, decoders_to_check, *input_file, source_type);
+            span.set_decoder_name(decoder_name);
+        }
 
-        if (!decoder)
+        if (decoder_name.empty())
         {
             return source_type == TaskSourceType::NestedDecoding
-                ? save(*this, input_file)
+                ? save(*this, input_file, "")
                 : false;
         }
 
-        ArgParser decoder_arg_parser;
-        const auto decorators = decoder->get_arg_parser_decorators();
-        for (const auto &decorator : decorators)
-            decorator.register_cli_options(decoder_arg_parser);
-        decoder_arg_parser.parse(task_context.unpacker_context.arguments);
-        for (const auto &decorator : decorators)
-            decorator.parse_cli_options(decoder_arg_parser);
-
-        ParallelDecoderAdapter adapter(shared_from_this(), input_file);
+        const auto decoder = task_context.get_configured_decoder(decoder_name);
+        ParallelDecoderAdapter adapter(
+            shared_from_this(), input_file, decoder_name);
         decoder->accept(adapter);
         return true;
     }
@@ -309,7 +376,7 @@ bool DecodeInputFileTask::work() const
     {
         logger.err("recognition finished with errors:\n%s\n", e.what());
         if (source_type == TaskSourceType::NestedDecoding)
-            save(*this, input_file);
+            save(*this, input_file, "");
         return false;
     }
 }
@@ -323,6 +390,7 @@ ProcessOutputFileTask::ProcessOutputFileTask(
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
     const std::shared_ptr<const dec::IDecoder> origin_decoder,
+    const std::string &origin_decoder_name,
     const std::string &target_name) :
         BaseParallelUnpackingTask(
             task_context,
@@ -333,6 +401,7 @@ ProcessOutputFileTask::ProcessOutputFileTask(
         input_file(input_file),
         file_factory(file_factory),
         origin_decoder(origin_decoder),
+        origin_decoder_name(origin_decoder_name),
         target_name(target_name)
 {
 }
@@ -350,11 +419,23 @@ bool ProcessOutputFileTask::work() const
         return false;
     }
 
+    // hold back new entries while too much decoded data is still in flight
+    task_context.memory_budget.wait(
+        task_context.task_scheduler.get_thread_count());
+
     io::File input_file_copy(*input_file);
     std::shared_ptr<io::File> output_file;
     try
     {
-        output_file = file_factory(input_file_copy, logger);
+        // small buffers made while decoding this entry come from a private
+        // arena rather than from the heap shared by all worker threads
+        Arena arena;
+        {
+            const Arena::Scope arena_scope(arena);
+            output_file = file_factory(input_file_copy, logger);
+        }
+        output_file = task_context.memory_budget.track(
+            move_out_of_arena(output_file));
         if (!output_file)
         {
             logger.info(
@@ -377,7 +458,7 @@ bool ProcessOutputFileTask::work() const
                 "error decoding \"%s\" (%s)\n", target_name.c_str(), e.what());
         }
         if (source_type == TaskSourceType::NestedDecoding)
-            save(*this, input_file);
+            save(*this, input_file, origin_decoder_name);
         return false;
     }
 
@@ -392,7 +473,7 @@ bool ProcessOutputFileTask::work() const
         naming_strategy, base_name, output_file->path);
 
     if (!task_context.unpacker_context.enable_nested_decoding)
-        return save(*this, output_file);
+        return save(*this, output_file, origin_decoder_name);
 
     auto linked_decoders = collect_linked_decoders(
         *origin_decoder, task_context.unpacker_context.registry);
@@ -400,12 +481,12 @@ bool ProcessOutputFileTask::work() const
         decoders_to_check.begin(), decoders_to_check.end());
 
     if (linked_decoders.empty())
-        return save(*this, output_file);
+        return save(*this, output_file, origin_decoder_name);
 
     if (get_depth() >= max_depth)
     {
         logger.warn("cycle detected.\n");
-        return save(*this, output_file);
+        return save(*this, output_file, origin_decoder_name);
     }
 
     task_context.task_scheduler.push_front(
@@ -472,6 +553,23 @@ bool ParallelUnpacker::run(const size_t thread_count)
 
     Logger logger(p->unpacker_context.logger);
 
+    const auto &trace_path = p->unpacker_context.trace_path;
+    if (p->task_context.trace_recorder.is_enabled())
+    {
+        try
+        {
+            p->task_context.trace_recorder.save(trace_path);
+            logger.info("Trace saved to %s\n", trace_path.c_str());
+        }
+        catch (const std::exception &e)
+        {
+            logger.err(
+                "Error saving trace to %s (%s)\n",
+                trace_path.c_str(),
+                e.what());
+        }
+    }
+
     logger.log(
         Logger::MessageType::Summary,
         "Executed %d tasks in %.02fs (",
@@ -19,11 +19,15 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include "dec/base_decoder.h"
 #include "dec/registry.h"
+#include "enc/base_image_encoder.h"
 #include "flow/ifile_saver.h"
+#include "flow/memory_budget.h"
 #include "flow/task_scheduler.h"
+#include "flow/trace_recorder.h"
 #include "logger.h"
 
 namespace au {
@@ -47,16 +51,22 @@ namespace flow {
             const Logger &logger,
             const IFileSaver &file_saver,
             const dec::Registry &registry,
+            const enc::BaseImageEncoder &image_encoder,
             const bool enable_nested_decoding,
             const std::vector<std::string> &arguments,
-            const std::set<std::string> &decoders_to_check);
+            const std::set<std::string> &decoders_to_check,
+            const uoff_t max_memory,
+            const io::path &trace_path);
 
         const Logger &logger;
         const IFileSaver &file_saver;
         const dec::Registry &registry;
+        const enc::BaseImageEncoder &image_encoder;
         const bool enable_nested_decoding;
         const std::vector<std::string> arguments;
         const std::set<std::string> decoders_to_check;
+        const uoff_t max_memory;
+        const io::path trace_path;
     };
 
     struct ParallelTaskContext final
@@ -66,9 +76,21 @@ namespace flow {
             const ParallelUnpackerContext &unpacker_context,
             TaskScheduler &task_scheduler);
 
+        // CLI options are the same for every task, so each decoder needs to
+        // be configured only once per run.
+        std::shared_ptr<const dec::IDecoder> get_configured_decoder(
+            const std::string &name);
+
         ParallelUnpacker &unpacker;
         const ParallelUnpackerContext &unpacker_context;
         TaskScheduler &task_scheduler;
+        const MemoryBudget memory_budget;
+        const TraceRecorder trace_recorder;
+
+    private:
+        std::mutex configured_decoders_mutex;
+        std::map<std::string, std::shared_ptr<const dec::IDecoder>>
+            configured_decoders;
     };
 
     struct BaseParallelUnpackingTask :
@@ -90,6 +112,7 @@ namespace flow {
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory,
             const dec::BaseDecoder &origin_decoder,
+            const std::string &origin_decoder_name,
             const std::string &custom_name = "") const;
 
         Logger logger;
@@ -16,21 +16,185 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/task_scheduler.h"
-#include <chrono>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 #include <thread>
 #include <vector>
+#include "algo/idle_helpers.h"
 #include "algo/range.h"
 
 using namespace au;
 using namespace au::flow;
 
+namespace
+{
+    struct TaskQueue final
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<ITask>> tasks;
+    };
+
+    struct WorkerIdentity final
+    {
+        const void *scheduler;
+        size_t index;
+    };
+}
+
+static thread_local WorkerIdentity current_worker = {nullptr, 0};
+
 struct TaskScheduler::Priv final
 {
-    std::deque<std::shared_ptr<ITask>> tasks;
-    std::vector<std::unique_ptr<std::thread>> threads;
+    Priv();
+
+    TaskQueue &get_queue_for_current_thread();
+    void push(std::shared_ptr<ITask> task, const bool front);
+    std::shared_ptr<ITask> pop(const size_t worker_index);
+    void work(const size_t worker_index);
+
+    TaskQueue injected_tasks;
+    std::vector<std::unique_ptr<TaskQueue>> worker_tasks;
+
+    // pending = queued + currently executing
+    std::atomic<long> queued_count;
+    std::atomic<long> pending_count;
+    std::atomic<long> sleeping_count;
+    std::atomic<int> success_count;
+    std::atomic<int> error_count;
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
 };
 
+TaskScheduler::Priv::Priv() :
+    queued_count(0),
+    pending_count(0),
+    sleeping_count(0),
+    success_count(0),
+    error_count(0)
+{
+}
+
+TaskQueue &TaskScheduler::Priv::get_queue_for_current_thread()
+{
+    if (current_worker.scheduler == this)
+        return *worker_tasks.at(current_worker.index);
+    return injected_tasks;
+}
+
+void TaskScheduler::Priv::push(std::shared_ptr<ITask> task, const bool front)
+{
+    ++pending_count;
+    {
+        auto &queue = get_queue_for_current_thread();
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        if (front)
+            queue.tasks.push_front(task);
+        else
+            queue.tasks.push_back(task);
+    }
+    ++queued_count;
+
+    if (sleeping_count > 0)
+    {
+        // taking the lock guarantees the sleeper is already waiting
+        {
+            std::unique_lock<std::mutex> lock(idle_mutex);
+        }
+        idle_cv.notify_one();
+    }
+}
+
+std::shared_ptr<ITask> TaskScheduler::Priv::pop(const size_t worker_index)
+{
+    std::shared_ptr<ITask> task;
+
+    {
+        auto &queue = *worker_tasks[worker_index];
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return task;
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(injected_tasks.mutex);
+        if (!injected_tasks.tasks.empty())
+        {
+            task = injected_tasks.tasks.front();
+            injected_tasks.tasks.pop_front();
+            return task;
+        }
+    }
+
+    for (const auto i : algo::range(1, worker_tasks.size()))
+    {
+        auto &queue = *worker_tasks[(worker_index + i) % worker_tasks.size()];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (lock.owns_lock() && !queue.tasks.empty())
+        {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+void TaskScheduler::Priv::work(const size_t worker_index)
+{
+    current_worker.scheduler = this;
+    current_worker.index = worker_index;
+
+    while (true)
+    {
+        const auto task = pop(worker_index);
+        if (task)
+        {
+            --queued_count;
+            const auto local_success = task->work();
+            if (local_success)
+                ++success_count;
+            else
+                ++error_count;
+
+            // children were pushed before this point, so reaching zero means
+            // there's truly nothing left to do
+            if (--pending_count == 0)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(idle_mutex);
+                }
+                idle_cv.notify_all();
+            }
+            continue;
+        }
+
+        // with no task to run, lend the thread to a long job of another one
+        if (algo::help_with_pending_request())
+            continue;
+
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        ++sleeping_count;
+        idle_cv.wait(lock, [&]()
+        {
+            return queued_count > 0
+                || pending_count == 0
+                || algo::has_pending_help_requests();
+        });
+        --sleeping_count;
+        if (pending_count == 0)
+            break;
+    }
+
+    current_worker.scheduler = nullptr;
+}
+
 TaskScheduler::TaskScheduler() : p(new Priv())
 {
 }
@@ -41,14 +205,17 @@ TaskScheduler::~TaskScheduler()
 
 void TaskScheduler::push_front(std::shared_ptr<ITask> task)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    p->tasks.push_front(task);
+    p->push(task, true);
 }
 
 void TaskScheduler::push_back(std::shared_ptr<ITask> task)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    p->tasks.push_back(task);
+    p->push(task, false);
+}
+
+size_t TaskScheduler::get_thread_count() const
+{
+    return p->worker_tasks.size();
 }
 
 TaskSchedulerResult TaskScheduler::run(size_t number_of_threads)
@@ -58,50 +225,35 @@ TaskSchedulerResult TaskScheduler::run(size_t number_of_threads)
     if (!number_of_threads)
         number_of_threads = 1;
 
-    TaskSchedulerResult result;
-    result.success_count = 0;
-    result.error_count = 0;
-    bool still_running = true;
-
+    p->success_count = 0;
+    p->error_count = 0;
+    p->worker_tasks.clear();
     for (const auto i : algo::range(number_of_threads))
+        p->worker_tasks.push_back(std::make_unique<TaskQueue>());
+
+    algo::add_help_listener(p.get(), [this]()
     {
-        p->threads.push_back(std::make_unique<std::thread>([&]()
         {
-            while (true)
-            {
-                std::shared_ptr<ITask> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(mutex);
-                    if (p->tasks.empty())
-                    {
-                        if (still_running && number_of_threads > 1)
-                        {
-                            lock.unlock();
-                            std::this_thread::sleep_for(
-                                std::chrono::milliseconds(10));
-                            continue;
-                        }
-                        break;
-                    }
-                    task = p->tasks.front();
-                    p->tasks.pop_front();
-                }
+            std::unique_lock<std::mutex> lock(p->idle_mutex);
+        }
+        p->idle_cv.notify_all();
+    });
 
-                const auto local_success = task->work();
-
-                {
-                    std::unique_lock<std::mutex> lock(mutex);
-                    result.success_count += local_success;
-                    result.error_count += !local_success;
-                    still_running = !p->tasks.empty();
-                }
-            }
+    std::vector<std::unique_ptr<std::thread>> threads;
+    for (const auto i : algo::range(number_of_threads))
+    {
+        threads.push_back(std::make_unique<std::thread>([this, i]()
+        {
+            p->work(i);
         }));
     }
 
-    for (auto &t : p->threads)
+    for (auto &t : threads)
         t->join();
+    algo::remove_help_listener(p.get());
 
+    TaskSchedulerResult result;
+    result.success_count = p->success_count;
+    result.error_count = p->error_count;
     return result;
 }
@@ -18,7 +18,6 @@
 #pragma once
 
 #include <memory>
-#include <mutex>
 
 namespace au {
 namespace flow {
@@ -36,6 +35,13 @@ namespace flow {
         int error_count;
     };
 
+    // Each worker owns a deque. Tasks pushed by a worker go to its own deque
+    // (front = run next, back = run last); tasks pushed from outside go to a
+    // shared injection queue. Idle workers steal from the back of other
+    // workers' deques and sleep on a condition variable when there's nothing
+    // to do, unless a running task asks for help through algo::HelpRequest.
+    // run() returns once no task is queued or being executed, so a task that
+    // pushes children before returning keeps the pool alive.
     class TaskScheduler final
     {
     public:
@@ -44,8 +50,7 @@ namespace flow {
         TaskSchedulerResult run(const size_t number_of_threads = 0);
         void push_front(std::shared_ptr<ITask> task);
         void push_back(std::shared_ptr<ITask> task);
-        void join();
-        std::mutex mutex;
+        size_t get_thread_count() const;
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
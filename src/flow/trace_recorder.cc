@@ -0,0 +1,166 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/trace_recorder.h"
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "algo/format.h"
+#include "algo/range.h"
+#include "algo/str.h"
+#include "io/file_byte_stream.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    struct TraceEvent final
+    {
+        std::string phase;
+        std::string decoder_name;
+        std::string file_name;
+        size_t thread_number;
+        double begin; // microseconds since the recorder was created
+        double duration;
+    };
+}
+
+struct TraceRecorder::Priv final
+{
+    Priv(const bool enabled);
+
+    const bool enabled;
+    const std::chrono::steady_clock::time_point origin;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    std::map<std::thread::id, size_t> thread_numbers;
+};
+
+TraceRecorder::Priv::Priv(const bool enabled)
+    : enabled(enabled), origin(std::chrono::steady_clock::now())
+{
+}
+
+TraceRecorder::TraceRecorder(const bool enabled) : p(new Priv(enabled))
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+}
+
+bool TraceRecorder::is_enabled() const
+{
+    return p->enabled;
+}
+
+void TraceRecorder::add_event(
+    const std::string &phase,
+    const std::string &decoder_name,
+    const std::string &file_name,
+    const std::chrono::steady_clock::time_point begin,
+    const std::chrono::steady_clock::time_point end) const
+{
+    if (!p->enabled)
+        return;
+
+    TraceEvent event;
+    event.phase = phase;
+    event.decoder_name = decoder_name;
+    event.file_name = file_name;
+    event.begin = std::chrono::duration<double, std::micro>(
+        begin - p->origin).count();
+    event.duration = std::chrono::duration<double, std::micro>(
+        end - begin).count();
+
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto thread_id = std::this_thread::get_id();
+    const auto it = p->thread_numbers.find(thread_id);
+    if (it == p->thread_numbers.end())
+    {
+        event.thread_number = p->thread_numbers.size() + 1;
+        p->thread_numbers[thread_id] = event.thread_number;
+    }
+    else
+        event.thread_number = it->second;
+    p->events.push_back(event);
+}
+
+void TraceRecorder::save(const io::path &path) const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    io::FileByteStream output_stream(path, io::FileMode::Write);
+    output_stream.write("{\"traceEvents\": [\n"_b);
+    for (const auto i : algo::range(p->events.size()))
+    {
+        const auto &event = p->events[i];
+        output_stream.write(algo::format(
+            "{"
+                "\"name\": \"%s\", "
+                "\"cat\": \"%s\", "
+                "\"ph\": \"X\", "
+                "\"ts\": %.03f, "
+                "\"dur\": %.03f, "
+                "\"pid\": 1, "
+                "\"tid\": %d, "
+                "\"args\": {\"decoder\": \"%s\", \"file\": \"%s\"}"
+            "}%s\n",
+            algo::escape_json(event.phase).c_str(),
+            algo::escape_json(event.decoder_name).c_str(),
+            event.begin,
+            event.duration,
+            static_cast<int>(event.thread_number),
+            algo::escape_json(event.decoder_name).c_str(),
+            algo::escape_json(event.file_name).c_str(),
+            i + 1 == static_cast<int>(p->events.size()) ? "" : ","));
+    }
+    output_stream.write("],\n\"displayTimeUnit\": \"ms\"}\n"_b);
+}
+
+TraceSpan::TraceSpan(
+    const TraceRecorder &recorder,
+    const std::string &phase,
+    const std::string &decoder_name,
+    const std::string &file_name) :
+        recorder(recorder),
+        phase(phase),
+        decoder_name(decoder_name),
+        file_name(file_name)
+{
+    if (recorder.is_enabled())
+        begin = std::chrono::steady_clock::now();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (recorder.is_enabled())
+    {
+        recorder.add_event(
+            phase,
+            decoder_name,
+            file_name,
+            begin,
+            std::chrono::steady_clock::now());
+    }
+}
+
+void TraceSpan::set_decoder_name(const std::string &decoder_name)
+{
+    this->decoder_name = decoder_name;
+}
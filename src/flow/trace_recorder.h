@@ -0,0 +1,73 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include "io/path.h"
+
+namespace au {
+namespace flow {
+
+    // Collects timings of individual unpacking phases and saves them in
+    // Chrome trace event format, viewable in chrome://tracing or Perfetto.
+    class TraceRecorder final
+    {
+    public:
+        TraceRecorder(const bool enabled);
+        ~TraceRecorder();
+
+        bool is_enabled() const;
+
+        void add_event(
+            const std::string &phase,
+            const std::string &decoder_name,
+            const std::string &file_name,
+            const std::chrono::steady_clock::time_point begin,
+            const std::chrono::steady_clock::time_point end) const;
+
+        void save(const io::path &path) const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+    // Records a single phase, from construction until destruction.
+    class TraceSpan final
+    {
+    public:
+        TraceSpan(
+            const TraceRecorder &recorder,
+            const std::string &phase,
+            const std::string &decoder_name,
+            const std::string &file_name);
+        ~TraceSpan();
+
+        void set_decoder_name(const std::string &decoder_name);
+
+    private:
+        const TraceRecorder &recorder;
+        const std::string phase;
+        std::string decoder_name;
+        const std::string file_name;
+        std::chrono::steady_clock::time_point begin;
+    };
+
+} }
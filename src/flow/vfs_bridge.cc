@@ -28,20 +28,29 @@ struct VirtualFileSystemBridge::Priv final
         const std::shared_ptr<dec::ArchiveMeta> meta,
         const std::shared_ptr<io::File> input_file,
         const io::path &base_name) :
-            logger(logger),
+            logger(std::make_shared<const Logger>(logger)),
             decoder(decoder),
             meta(meta),
             base_name(base_name),
             decoder_refcount(decoder.shared_from_this())
     {
+        // lookups run the factories outside the file system's lock, so they
+        // may still be running after this bridge is gone; they hold on to
+        // everything they use rather than refer to the bridge or its owner
+        const auto shared_logger = this->logger;
+        const auto shared_decoder = decoder_refcount;
+        const auto archive_decoder = &decoder;
         for (const auto &entry : meta->entries)
         {
+            const auto entry_ptr = entry.get();
             VirtualFileSystem::register_file(
                 get_target_name(entry->path),
-                [&logger, input_file, meta, &entry, &decoder]()
+                [shared_logger, shared_decoder, archive_decoder, input_file,
+                    meta, entry_ptr]()
                 {
                     io::File file_copy(*input_file);
-                    return decoder.read_file(logger, file_copy, *meta, *entry);
+                    return archive_decoder->read_file(
+                        *shared_logger, file_copy, *meta, *entry_ptr);
                 });
         }
     }
@@ -61,7 +70,7 @@ struct VirtualFileSystemBridge::Priv final
             decoder.naming_strategy(), base_name, input_path);
     }
 
-    const Logger logger;
+    const std::shared_ptr<const Logger> logger;
     const dec::BaseArchiveDecoder &decoder;
     const std::shared_ptr<dec::ArchiveMeta> meta;
     const io::path base_name;
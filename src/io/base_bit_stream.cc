@@ -17,7 +17,6 @@
 
 #include "io/base_bit_stream.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::io;
@@ -28,8 +27,9 @@ BaseBitStream::BaseBitStream(const bstr &input) :
     buffer(0),
     bits_available(0),
     position(0),
-    own_stream_holder(new MemoryByteStream(input)),
-    input_stream(own_stream_holder.get())
+    input_data(input),
+    input_data_pos(0),
+    input_stream(nullptr)
 {
 }
 
@@ -37,6 +37,7 @@ BaseBitStream::BaseBitStream(io::BaseByteStream &input_stream) :
     buffer(0),
     bits_available(0),
     position(0),
+    input_data_pos(0),
     input_stream(&input_stream)
 {
 }
@@ -48,7 +49,10 @@ BaseStream &BaseBitStream::seek(const uoff_t new_pos)
     position = (new_pos / 32) * 32;
     bits_available = 0;
     buffer = 0;
-    input_stream->seek(position / 8);
+    if (input_stream)
+        input_stream->seek(position / 8);
+    else
+        input_data_pos = position / 8;
     read(new_pos % 32);
     return *this;
 }
@@ -65,7 +69,14 @@ uoff_t BaseBitStream::pos() const
 
 uoff_t BaseBitStream::size() const
 {
-    return input_stream->size() * 8;
+    return (input_stream ? input_stream->size() : input_data.size()) * 8;
+}
+
+uoff_t BaseBitStream::bytes_left() const
+{
+    return input_stream
+        ? input_stream->left()
+        : input_data.size() - input_data_pos;
 }
 
 // Elias Gamma coding
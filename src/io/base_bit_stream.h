@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "err.h"
 #include "io/base_byte_stream.h"
 #include "io/base_stream.h"
 #include "types.h"
@@ -42,10 +43,24 @@ namespace io {
         virtual void write(const size_t bits, const u32 value);
 
     protected:
+        // Input bytes come either straight from input_data, when the stream
+        // was constructed from a bstr, or from input_stream otherwise.
+        u8 read_byte()
+        {
+            if (input_stream)
+                return input_stream->read<u8>();
+            if (input_data_pos >= input_data.size())
+                throw err::EofError();
+            return input_data.get<const u8>()[input_data_pos++];
+        }
+
+        uoff_t bytes_left() const;
+
         u64 buffer;
         size_t bits_available;
         size_t position;
-        std::unique_ptr<io::BaseByteStream> own_stream_holder;
+        const bstr input_data;
+        size_t input_data_pos;
         io::BaseByteStream *input_stream;
     };
 
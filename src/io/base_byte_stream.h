@@ -21,6 +21,7 @@
 #include <memory>
 #include "algo/endian.h"
 #include "io/base_stream.h"
+#include "io/file_range.h"
 #include "types.h"
 
 namespace au {
@@ -50,6 +51,27 @@ namespace io {
             return *this;
         }
 
+        // Tells where the stream's bytes are stored verbatim on disk, if
+        // they are, so that they can be copied without being read.
+        virtual bool get_file_range(FileRange &range) const
+        {
+            return false;
+        }
+
+        // Hints that the given range is about to be read, so that it can be
+        // fetched ahead of time. Streams that can't make use of it ignore it.
+        virtual void prefetch(const uoff_t offset, const uoff_t size)
+        {
+        }
+
+        // Returns the given range without copying it if the stream holds it
+        // in memory, or nullptr otherwise. The pointer is valid until the
+        // stream is written to or destroyed. Doesn't move the position.
+        virtual const u8 *get_view(const uoff_t offset, const size_t size) const
+        {
+            return nullptr;
+        }
+
         bstr read_to_zero();
         bstr read_to_zero(const size_t bytes);
         bstr read_to_eof();
@@ -59,11 +81,31 @@ namespace io {
         {
             if (!bytes)
                 return ""_b;
-            bstr ret(bytes);
+            bstr ret;
+            ret.resize_uninitialized(bytes);
             read_impl(&ret[0], bytes);
             return ret;
         }
 
+        // Reads bytes at the given offset without moving the stream position.
+        // Several threads can do this on one stream at the same time, as
+        // long as nothing else uses it meanwhile.
+        void read_at(const uoff_t offset, void *destination, const size_t size)
+        {
+            if (size)
+                read_at_impl(offset, destination, size);
+        }
+
+        bstr read_at(const uoff_t offset, const size_t bytes)
+        {
+            if (!bytes)
+                return ""_b;
+            bstr ret;
+            ret.resize_uninitialized(bytes);
+            read_at_impl(offset, &ret[0], bytes);
+            return ret;
+        }
+
         template<typename T> T read()
         {
             static_assert(
@@ -153,6 +195,8 @@ namespace io {
 
     protected:
         virtual void read_impl(void *input, const size_t size) = 0;
+        virtual void read_at_impl(
+            const uoff_t offset, void *destination, const size_t size) = 0;
         virtual void write_impl(const void *str, const size_t size) = 0;
         virtual void seek_impl(const uoff_t offset) = 0;
         virtual void resize_impl(const uoff_t new_size) = 0;
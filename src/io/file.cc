@@ -16,8 +16,11 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/file.h"
+#include <atomic>
 #include <string>
+#include "err.h"
 #include "io/file_byte_stream.h"
+#include "io/mapped_byte_stream.h"
 #include "io/memory_byte_stream.h"
 
 using namespace au;
@@ -36,6 +39,29 @@ static const std::vector<std::pair<bstr, std::string>> magic_definitions
     {"\x00\x00\x00\x14""ftypisom"_b, "mp4"},
 };
 
+static std::atomic<bool> file_mapping_enabled(true);
+
+static std::unique_ptr<BaseByteStream> open_stream(
+    const io::path &path, const FileMode mode)
+{
+    if (mode == FileMode::Read && file_mapping_enabled)
+    {
+        try
+        {
+            return std::make_unique<MappedByteStream>(path);
+        }
+        catch (const err::FileNotFoundError &)
+        {
+            throw;
+        }
+        catch (const err::IoError &)
+        {
+            // not a regular file, or no address space left for it
+        }
+    }
+    return std::make_unique<FileByteStream>(path, mode);
+}
+
 File::File(File &other_file) :
     stream_holder(other_file.stream.clone()),
     stream(*stream_holder),
@@ -51,7 +77,7 @@ File::File(const io::path &path, std::unique_ptr<BaseByteStream> stream) :
 }
 
 File::File(const io::path &path, const FileMode mode) :
-    File(path, std::make_unique<FileByteStream>(path, mode))
+    File(path, open_stream(path, mode))
 {
 }
 
@@ -85,3 +111,8 @@ void File::guess_extension()
     }
     stream.seek(old_pos);
 }
+
+void io::set_file_mapping_enabled(const bool enabled)
+{
+    file_mapping_enabled = enabled;
+}
@@ -43,4 +43,9 @@ namespace io {
 
     };
 
+    // Files opened for reading are mapped into memory unless this is turned
+    // off. Accessing a mapping of a file that was truncated in the meantime
+    // faults, so runs that can overwrite their own inputs turn it off.
+    void set_file_mapping_enabled(const bool enabled);
+
 } }
@@ -16,7 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/file_byte_stream.h"
-#include <cstdio>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
 #include "algo/locale.h"
 #include "err.h"
 
@@ -25,105 +27,160 @@
     #include <io.h>
     #include <sys/stat.h>
     #include <sys/types.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
 #endif
 
 using namespace au;
 using namespace au::io;
 
-struct FileByteStream::Priv final
+namespace
 {
-    #if _WIN32
-        Priv(const path &path, FileMode mode) : path(path), mode(mode)
-        {
-            fd = _wopen(
-                path.wstr().c_str(),
-                (mode == FileMode::Write
-                    ? (_O_RDWR | _O_CREAT | _O_TRUNC)
-                    : _O_RDONLY)
-                | _O_BINARY,
-                _S_IREAD | _S_IWRITE);
-            if (fd == -1)
-                throw err::FileNotFoundError("Could not open " + path.str());
-        }
+    // OS file handle shared by a stream and all of its clones. Every stream
+    // keeps its own position and passes it to each call, so the handle is
+    // never seeked and clones don't get in each other's way.
+    struct Handle final
+    {
+        Handle(const io::path &path, const FileMode mode);
+        ~Handle();
 
-        ~Priv()
-        {
-            _close(fd);
-        }
+        void read_at(const uoff_t offset, void *destination, const size_t size);
+        void write_at(
+            const uoff_t offset, const void *source, const size_t size);
 
-        uoff_t tell()
-        {
-            return _telli64(fd);
-        }
+        const io::path path;
+        const FileMode mode;
+        int fd;
+        std::atomic<uoff_t> size;
 
-        void seek(const uoff_t offset, const int whence)
-        {
-            _lseeki64(fd, offset, whence);
-        }
+        #if _WIN32
+            // there's no pread, so positional calls take turns
+            std::mutex mutex;
+        #endif
+    };
+}
 
-        void read(void *source, const size_t size)
-        {
-            const size_t ret = _read(fd, source, size);
-            if (ret != size)
-                throw err::EofError();
-        }
+#if _WIN32
+    Handle::Handle(const io::path &path, const FileMode mode)
+        : path(path), mode(mode), size(0)
+    {
+        fd = _wopen(
+            path.wstr().c_str(),
+            (mode == FileMode::Write
+                ? (_O_RDWR | _O_CREAT | _O_TRUNC)
+                : _O_RDONLY)
+            | _O_BINARY,
+            _S_IREAD | _S_IWRITE);
+        if (fd == -1)
+            throw err::FileNotFoundError("Could not open " + path.str());
+        size = _lseeki64(fd, 0, SEEK_END);
+    }
 
-        void write(const void *destination, const size_t size)
-        {
-            const size_t ret = _write(fd, destination, size);
-            if (ret != size)
-                throw err::IoError("Could not write full data");
-        }
+    Handle::~Handle()
+    {
+        _close(fd);
+    }
 
-        int fd;
-    #else
-        Priv(const path &path, FileMode mode) : path(path), mode(mode)
-        {
-            fd = std::fopen(
-                path.c_str(),
-                mode == FileMode::Write ? "w+b" : "rb");
-            if (!fd)
-                throw err::FileNotFoundError("Could not open " + path.str());
-        }
+    void Handle::read_at(
+        const uoff_t offset, void *destination, const size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        _lseeki64(fd, offset, SEEK_SET);
+        const size_t ret = _read(fd, destination, size);
+        if (ret != size)
+            throw err::EofError();
+    }
 
-        ~Priv()
+    void Handle::write_at(
+        const uoff_t offset, const void *source, const size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        _lseeki64(fd, offset, SEEK_SET);
+        const size_t ret = _write(fd, source, size);
+        if (ret != size)
+            throw err::IoError("Could not write full data");
+    }
+#else
+    Handle::Handle(const io::path &path, const FileMode mode)
+        : path(path), mode(mode), size(0)
+    {
+        fd = open(
+            path.c_str(),
+            mode == FileMode::Write ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY,
+            0666);
+        if (fd == -1)
+            throw err::FileNotFoundError("Could not open " + path.str());
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
         {
-            fclose(fd);
+            close(fd);
+            throw err::IoError("Could not get size of " + path.str());
         }
+        size = file_stat.st_size;
+    }
 
-        uoff_t tell()
-        {
-            return ftello(fd);
-        }
+    Handle::~Handle()
+    {
+        close(fd);
+    }
 
-        void seek(const uoff_t offset, const int whence)
+    void Handle::read_at(
+        const uoff_t offset, void *destination, const size_t size)
+    {
+        auto destination_ptr = reinterpret_cast<u8*>(destination);
+        size_t done = 0;
+        while (done < size)
         {
-            const auto ret = fseeko(fd, offset, whence);
-            if (ret != 0)
+            const auto ret = pread(
+                fd, destination_ptr + done, size - done, offset + done);
+            if (ret == -1 && errno == EINTR)
+                continue;
+            if (ret <= 0)
                 throw err::EofError();
+            done += ret;
         }
+    }
 
-        void read(void *source, const size_t size)
+    void Handle::write_at(
+        const uoff_t offset, const void *source, const size_t size)
+    {
+        auto source_ptr = reinterpret_cast<const u8*>(source);
+        size_t done = 0;
+        while (done < size)
         {
-            if (fread(source, 1, size, fd) != size)
-                throw err::EofError();
-        }
-
-        void write(const void *destination, const size_t size)
-        {
-            if (fwrite(destination, 1, size, fd) != size)
+            const auto ret = pwrite(
+                fd, source_ptr + done, size - done, offset + done);
+            if (ret == -1 && errno == EINTR)
+                continue;
+            if (ret <= 0)
                 throw err::IoError("Could not write full data");
+            done += ret;
         }
+    }
+#endif
 
-        FILE *fd;
-    #endif
+struct FileByteStream::Priv final
+{
+    Priv(const std::shared_ptr<Handle> handle, const uoff_t pos);
 
-    io::path path;
-    FileMode mode;
+    std::shared_ptr<Handle> handle;
+    uoff_t pos;
 };
 
+FileByteStream::Priv::Priv(
+    const std::shared_ptr<Handle> handle, const uoff_t pos)
+        : handle(handle), pos(pos)
+{
+}
+
 FileByteStream::FileByteStream(const path &path, const FileMode mode)
-    : p(new Priv(path, mode))
+    : p(new Priv(std::make_shared<Handle>(path, mode), 0))
+{
+}
+
+FileByteStream::FileByteStream(std::unique_ptr<Priv> p) : p(std::move(p))
 {
 }
 
@@ -135,33 +192,65 @@ void FileByteStream::seek_impl(const uoff_t offset)
 {
     if (offset > size())
         throw err::EofError();
-    p->seek(offset, SEEK_SET);
+    p->pos = offset;
 }
 
 void FileByteStream::read_impl(void *destination, const size_t size)
 {
-    // destination MUST exist and size MUST be at least 1
-    p->read(destination, size);
+    read_at_impl(p->pos, destination, size);
+    p->pos += size;
+}
+
+void FileByteStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
+{
+    if (offset > this->size() || size > this->size() - offset)
+        throw err::EofError();
+    p->handle->read_at(offset, destination, size);
 }
 
 void FileByteStream::write_impl(const void *source, const size_t size)
 {
-    // source MUST exist and size MUST be at least 1
-    p->write(source, size);
+    p->handle->write_at(p->pos, source, size);
+    p->pos += size;
+
+    // clones may be writing too, so the size only ever grows
+    auto old_size = p->handle->size.load();
+    while (old_size < p->pos
+        && !p->handle->size.compare_exchange_weak(old_size, p->pos))
+    {
+    }
 }
 
 uoff_t FileByteStream::pos() const
 {
-    return p->tell();
+    return p->pos;
 }
 
 uoff_t FileByteStream::size() const
 {
-    const auto old_pos = p->tell();
-    p->seek(0, SEEK_END);
-    const auto size = p->tell();
-    p->seek(old_pos, SEEK_SET);
-    return size;
+    return p->handle->size;
+}
+
+bool FileByteStream::get_file_range(FileRange &range) const
+{
+    if (p->handle->mode != FileMode::Read)
+        return false;
+    range.path = p->handle->path;
+    range.offset = 0;
+    range.size = size();
+    return true;
+}
+
+void FileByteStream::prefetch(const uoff_t offset, const uoff_t size)
+{
+    #if _WIN32
+        // no equivalent for plain descriptors
+    #else
+        #ifdef POSIX_FADV_WILLNEED
+            posix_fadvise(p->handle->fd, offset, size, POSIX_FADV_WILLNEED);
+        #endif
+    #endif
 }
 
 void FileByteStream::resize_impl(const uoff_t new_size)
@@ -173,7 +262,6 @@ void FileByteStream::resize_impl(const uoff_t new_size)
 
 std::unique_ptr<io::BaseByteStream> FileByteStream::clone() const
 {
-    auto ret = std::make_unique<FileByteStream>(p->path, p->mode);
-    ret->seek(pos());
-    return std::move(ret);
+    return std::unique_ptr<FileByteStream>(
+        new FileByteStream(std::make_unique<Priv>(p->handle, p->pos)));
 }
@@ -31,6 +31,8 @@ namespace io {
         Write = 2,
     };
 
+    // Clones share one OS handle; each keeps its own position and reads
+    // with positional calls. The size of read-only files is cached.
     class FileByteStream final : public BaseByteStream
     {
     public:
@@ -39,17 +41,25 @@ namespace io {
 
         uoff_t size() const override;
         uoff_t pos() const override;
+        bool get_file_range(FileRange &range) const override;
+        void prefetch(const uoff_t offset, const uoff_t size) override;
 
         std::unique_ptr<BaseByteStream> clone() const override;
 
     protected:
         void read_impl(void *destination, const size_t size) override;
+        void read_at_impl(
+            const uoff_t offset,
+            void *destination,
+            const size_t size) override;
         void write_impl(const void *source, const size_t size) override;
         void seek_impl(const uoff_t offset) override;
         void resize_impl(const uoff_t new_size) override;
 
     private:
         struct Priv;
+        FileByteStream(std::unique_ptr<Priv> p);
+
         std::unique_ptr<Priv> p;
     };
 
@@ -0,0 +1,92 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/file_range.h"
+#include "io/file_byte_stream.h"
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/sendfile.h>
+    #include <unistd.h>
+#endif
+
+using namespace au;
+using namespace au::io;
+
+#ifdef __linux__
+    static bool copy_in_kernel(const FileRange &range, const path &target_path)
+    {
+        const auto source_fd = open(range.path.c_str(), O_RDONLY);
+        if (source_fd == -1)
+            return false;
+        const auto target_fd = open(
+            target_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (target_fd == -1)
+        {
+            close(source_fd);
+            return false;
+        }
+
+        // copy_file_range can share extents on filesystems that support it,
+        // but refuses to work across filesystems on older kernels
+        auto use_copy_file_range = true;
+        loff_t offset = range.offset;
+        auto left = range.size;
+        while (left)
+        {
+            ssize_t ret;
+            if (use_copy_file_range)
+            {
+                ret = ::copy_file_range(
+                    source_fd, &offset, target_fd, nullptr, left, 0);
+                if (ret == -1 && errno != EINTR)
+                {
+                    use_copy_file_range = false;
+                    continue;
+                }
+            }
+            else
+            {
+                off_t sendfile_offset = offset;
+                ret = sendfile(target_fd, source_fd, &sendfile_offset, left);
+                offset = sendfile_offset;
+            }
+            if (ret == -1 && errno == EINTR)
+                continue;
+            if (ret <= 0)
+                break;
+            left -= ret;
+        }
+
+        close(source_fd);
+        close(target_fd);
+        return !left;
+    }
+#endif
+
+void io::copy_file_range(const FileRange &range, const path &target_path)
+{
+    #ifdef __linux__
+        if (copy_in_kernel(range, target_path))
+            return;
+    #endif
+    FileByteStream source_stream(range.path, FileMode::Read);
+    source_stream.seek(range.offset);
+    FileByteStream(target_path, FileMode::Write)
+        .write(source_stream, range.size);
+}
@@ -0,0 +1,38 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "io/path.h"
+#include "types.h"
+
+namespace au {
+namespace io {
+
+    // Run of bytes stored verbatim in a file on disk.
+    struct FileRange final
+    {
+        io::path path;
+        uoff_t offset;
+        uoff_t size;
+    };
+
+    // Writes the bytes of the range to a new file. Where the platform allows
+    // it, the kernel moves the data and it never reaches user space.
+    void copy_file_range(const FileRange &range, const path &target_path);
+
+} }
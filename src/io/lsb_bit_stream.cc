@@ -16,6 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/lsb_bit_stream.h"
+#include <cstring>
+#include "algo/endian.h"
+#include "algo/range.h"
 
 using namespace au;
 using namespace au::io;
@@ -29,14 +32,60 @@ LsbBitStream::LsbBitStream(io::BaseByteStream &input_stream)
 {
 }
 
-u32 LsbBitStream::read(const size_t bits)
+void LsbBitStream::refill(const size_t bits)
 {
-    while (bits_available < bits)
+    // fast path: load as many whole bytes as fit with a single word read
+    if (!input_stream && input_data_pos + 8 <= input_data.size())
     {
-        const auto tmp = input_stream->read<u8>();
+        u64 word;
+        std::memcpy(&word, input_data.get<const u8>() + input_data_pos, 8);
+        word = algo::from_little_endian(word);
+        const auto bytes = (64 - bits_available) / 8;
+        if (bytes < 8)
+            word &= (1ull << (bytes * 8)) - 1;
+        buffer |= word << bits_available;
+        bits_available += bytes * 8;
+        input_data_pos += bytes;
+        return;
+    }
+
+    const auto bytes = std::min<uoff_t>(
+        (bits - bits_available + 7) / 8, bytes_left());
+    for (const auto i : algo::range(bytes))
+    {
+        const u64 tmp = read_byte();
         buffer |= tmp << bits_available;
         bits_available += 8;
     }
+}
+
+u32 LsbBitStream::peek(const size_t bits)
+{
+    if (bits_available < bits)
+        refill(bits);
+    const auto mask = (1ull << bits) - 1;
+    return buffer & mask;
+}
+
+void LsbBitStream::consume(const size_t bits)
+{
+    if (bits_available < bits)
+        refill(bits);
+    if (bits_available < bits)
+        throw err::EofError();
+    buffer >>= bits;
+    bits_available -= bits;
+    position += bits;
+}
+
+u32 LsbBitStream::read(const size_t bits)
+{
+    if (bits_available < bits)
+    {
+        refill(bits);
+        if (bits_available < bits)
+            throw err::EofError();
+    }
     const auto mask = (1ull << bits) - 1;
     const auto value = buffer & mask;
     buffer >>= bits;
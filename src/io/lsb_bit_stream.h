@@ -29,6 +29,14 @@ namespace io {
         LsbBitStream(const bstr &input);
         LsbBitStream(io::BaseByteStream &input_stream);
         u32 read(const size_t n) override;
+
+        // For table-driven decoding: peek() returns upcoming bits without
+        // consuming them, treating bits past the end of input as zeros.
+        u32 peek(const size_t n);
+        void consume(const size_t n);
+
+    private:
+        void refill(const size_t n);
     };
 
 } }
@@ -0,0 +1,244 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/mapped_byte_stream.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "err.h"
+
+#if _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace au;
+using namespace au::io;
+
+struct MappedByteStream::Mapping final
+{
+    Mapping(const path &path);
+    ~Mapping();
+
+    const io::path file_path;
+    const u8 *data;
+    uoff_t size;
+};
+
+#if _WIN32
+    MappedByteStream::Mapping::Mapping(const path &path)
+        : file_path(path), data(nullptr), size(0)
+    {
+        const auto file = CreateFileW(
+            path.wstr().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw err::FileNotFoundError("Could not open " + path.str());
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            throw err::IoError("Could not get size of " + path.str());
+        }
+        size = file_size.QuadPart;
+        if (!size)
+        {
+            CloseHandle(file);
+            return;
+        }
+        if (size > std::numeric_limits<size_t>::max())
+        {
+            CloseHandle(file);
+            throw err::IoError("Too large to map: " + path.str());
+        }
+
+        const auto file_mapping = CreateFileMappingW(
+            file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!file_mapping)
+            throw err::IoError("Could not map " + path.str());
+
+        data = reinterpret_cast<const u8*>(
+            MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(file_mapping);
+        if (!data)
+            throw err::IoError("Could not map " + path.str());
+    }
+
+    MappedByteStream::Mapping::~Mapping()
+    {
+        if (data)
+            UnmapViewOfFile(data);
+    }
+#else
+    MappedByteStream::Mapping::Mapping(const path &path)
+        : file_path(path), data(nullptr), size(0)
+    {
+        const auto fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw err::FileNotFoundError("Could not open " + path.str());
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+        {
+            close(fd);
+            throw err::IoError("Could not map " + path.str());
+        }
+        size = file_stat.st_size;
+        if (!size)
+        {
+            close(fd);
+            return;
+        }
+        // 32-bit builds can't map files of 4 GiB or more
+        if (size > std::numeric_limits<size_t>::max())
+        {
+            close(fd);
+            throw err::IoError("Too large to map: " + path.str());
+        }
+
+        // nothing is ever written through the mapping, so keep it private
+        const auto ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED)
+            throw err::IoError("Could not map " + path.str());
+        data = reinterpret_cast<const u8*>(ptr);
+    }
+
+    MappedByteStream::Mapping::~Mapping()
+    {
+        if (data)
+            munmap(const_cast<u8*>(data), size);
+    }
+#endif
+
+MappedByteStream::MappedByteStream(const std::shared_ptr<const Mapping> mapping)
+    : mapping(mapping), mapping_pos(0)
+{
+}
+
+MappedByteStream::MappedByteStream(const path &path)
+    : MappedByteStream(std::make_shared<const Mapping>(path))
+{
+}
+
+MappedByteStream::~MappedByteStream()
+{
+}
+
+bool MappedByteStream::get_file_range(FileRange &range) const
+{
+    range.path = mapping->file_path;
+    range.offset = 0;
+    range.size = mapping->size;
+    return true;
+}
+
+void MappedByteStream::prefetch(const uoff_t offset, const uoff_t size)
+{
+    if (offset >= mapping->size)
+        return;
+    #if _WIN32
+        // PrefetchVirtualMemory isn't available before Windows 8
+    #else
+        const auto page_size = static_cast<uoff_t>(sysconf(_SC_PAGESIZE));
+        const auto start = offset - offset % page_size;
+        const auto end = std::min(mapping->size, offset + size);
+        madvise(
+            const_cast<u8*>(mapping->data) + start,
+            end - start,
+            MADV_WILLNEED);
+    #endif
+}
+
+const u8 *MappedByteStream::get_view(
+    const uoff_t offset, const size_t size) const
+{
+    if (offset > mapping->size || size > mapping->size - offset)
+        return nullptr;
+    return mapping->data + offset;
+}
+
+const u8 *MappedByteStream::read_view(const size_t size)
+{
+    if (mapping_pos + size > mapping->size)
+        throw err::EofError();
+    const auto ret = mapping->data + mapping_pos;
+    mapping_pos += size;
+    return ret;
+}
+
+void MappedByteStream::seek_impl(const uoff_t offset)
+{
+    if (offset > mapping->size)
+        throw err::EofError();
+    mapping_pos = offset;
+}
+
+void MappedByteStream::read_impl(void *destination, const size_t size)
+{
+    // destination MUST exist and size MUST be at least 1
+    std::memcpy(destination, read_view(size), size);
+}
+
+void MappedByteStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
+{
+    if (offset > mapping->size || size > mapping->size - offset)
+        throw err::EofError();
+    std::memcpy(destination, mapping->data + offset, size);
+}
+
+void MappedByteStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Writing to mapped files is not supported");
+}
+
+uoff_t MappedByteStream::pos() const
+{
+    return mapping_pos;
+}
+
+uoff_t MappedByteStream::size() const
+{
+    return mapping->size;
+}
+
+void MappedByteStream::resize_impl(const uoff_t new_size)
+{
+    if (new_size == size())
+        return;
+    throw err::NotSupportedError("Resizing mapped files is not supported");
+}
+
+std::unique_ptr<io::BaseByteStream> MappedByteStream::clone() const
+{
+    auto ret = std::unique_ptr<MappedByteStream>(
+        new MappedByteStream(mapping));
+    ret->seek(pos());
+    return ret;
+}
@@ -0,0 +1,68 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include "io/base_byte_stream.h"
+#include "io/path.h"
+
+namespace au {
+namespace io {
+
+    // Read-only stream over a file mapped into memory. Reads are served
+    // straight from the mapping and clones share it. The file must not be
+    // truncated while it is mapped; see io::set_file_mapping_enabled().
+    class MappedByteStream final : public BaseByteStream
+    {
+    public:
+        MappedByteStream(const path &path);
+        ~MappedByteStream();
+
+        uoff_t size() const override;
+        uoff_t pos() const override;
+        bool get_file_range(FileRange &range) const override;
+        void prefetch(const uoff_t offset, const uoff_t size) override;
+        const u8 *get_view(
+            const uoff_t offset, const size_t size) const override;
+
+        // Returns the next bytes without copying them and moves past them.
+        // The pointer is valid for as long as this stream or its clones are.
+        const u8 *read_view(const size_t size);
+
+        std::unique_ptr<BaseByteStream> clone() const override;
+
+    protected:
+        void read_impl(void *destination, const size_t size) override;
+        void read_at_impl(
+            const uoff_t offset,
+            void *destination,
+            const size_t size) override;
+        void write_impl(const void *source, const size_t size) override;
+        void seek_impl(const uoff_t offset) override;
+        void resize_impl(const uoff_t new_size) override;
+
+    private:
+        struct Mapping;
+
+        MappedByteStream(const std::shared_ptr<const Mapping> mapping);
+
+        std::shared_ptr<const Mapping> mapping;
+        uoff_t mapping_pos;
+    };
+
+} }
@@ -63,6 +63,14 @@ io::BaseByteStream &MemoryByteStream::reserve(const uoff_t size)
     return *this;
 }
 
+const u8 *MemoryByteStream::get_view(
+    const uoff_t offset, const size_t size) const
+{
+    if (offset > buffer->size() || size > buffer->size() - offset)
+        return nullptr;
+    return buffer->get<const u8>() + offset;
+}
+
 void MemoryByteStream::seek_impl(const uoff_t offset)
 {
     if (offset > buffer->size())
@@ -81,6 +89,14 @@ void MemoryByteStream::read_impl(void *destination, const size_t size)
     std::memcpy(destination_ptr, source_ptr, size);
 }
 
+void MemoryByteStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
+{
+    if (offset > buffer->size() || size > buffer->size() - offset)
+        throw err::EofError();
+    std::memcpy(destination, buffer->get<const u8>() + offset, size);
+}
+
 void MemoryByteStream::write_impl(const void *source, size_t size)
 {
     // source MUST exist and size MUST be at least 1
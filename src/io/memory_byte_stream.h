@@ -39,11 +39,17 @@ namespace io {
         uoff_t pos() const override;
 
         BaseByteStream &reserve(const uoff_t count);
+        const u8 *get_view(
+            const uoff_t offset, const size_t size) const override;
 
         std::unique_ptr<BaseByteStream> clone() const override;
 
     protected:
         void read_impl(void *destination, const size_t size) override;
+        void read_at_impl(
+            const uoff_t offset,
+            void *destination,
+            const size_t size) override;
         void write_impl(const void *source, const size_t size) override;
         void seek_impl(const uoff_t offset) override;
         void resize_impl(const uoff_t new_size) override;
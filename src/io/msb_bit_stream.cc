@@ -16,6 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/msb_bit_stream.h"
+#include <cstring>
+#include "algo/endian.h"
+#include "algo/range.h"
 
 using namespace au;
 using namespace au::io;
@@ -44,14 +47,60 @@ void MsbBitStream::flush()
     }
 }
 
-u32 MsbBitStream::read(const size_t bits)
+void MsbBitStream::refill(const size_t bits)
 {
-    while (bits_available < bits)
+    // fast path: load as many whole bytes as fit with a single word read
+    if (!input_stream && input_data_pos + 8 <= input_data.size())
     {
-        const auto tmp = input_stream->read<u8>();
-        buffer = (buffer << 8) | tmp;
+        u64 word;
+        std::memcpy(&word, input_data.get<const u8>() + input_data_pos, 8);
+        word = algo::from_big_endian(word);
+        const auto bytes = (64 - bits_available) / 8;
+        buffer = bytes == 8
+            ? word
+            : (buffer << (bytes * 8)) | (word >> (64 - bytes * 8));
+        bits_available += bytes * 8;
+        input_data_pos += bytes;
+        return;
+    }
+
+    const auto bytes = std::min<uoff_t>(
+        (bits - bits_available + 7) / 8, bytes_left());
+    for (const auto i : algo::range(bytes))
+    {
+        buffer = (buffer << 8) | read_byte();
         bits_available += 8;
     }
+}
+
+u32 MsbBitStream::peek(const size_t bits)
+{
+    if (bits_available < bits)
+        refill(bits);
+    const auto mask = (1ull << bits) - 1;
+    if (bits_available < bits)
+        return (buffer << (bits - bits_available)) & mask;
+    return (buffer >> (bits_available - bits)) & mask;
+}
+
+void MsbBitStream::consume(const size_t bits)
+{
+    if (bits_available < bits)
+        refill(bits);
+    if (bits_available < bits)
+        throw err::EofError();
+    bits_available -= bits;
+    position += bits;
+}
+
+u32 MsbBitStream::read(const size_t bits)
+{
+    if (bits_available < bits)
+    {
+        refill(bits);
+        if (bits_available < bits)
+            throw err::EofError();
+    }
     const auto mask = (1ull << bits) - 1;
     bits_available -= bits;
     position += bits;
@@ -60,6 +109,8 @@ u32 MsbBitStream::read(const size_t bits)
 
 void MsbBitStream::write(const size_t bits, const u32 value)
 {
+    if (!input_stream)
+        throw err::NotSupportedError("Writing to bstr input is not supported");
     const auto mask = (1ull << bits) - 1;
     buffer <<= bits;
     buffer |= value & mask;
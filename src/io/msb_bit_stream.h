@@ -32,7 +32,15 @@ namespace io {
         u32 read(const size_t bits) override;
         void flush() override;
         void write(const size_t bits, const u32 value) override;
+
+        // For table-driven decoding: peek() returns upcoming bits without
+        // consuming them, treating bits past the end of input as zeros.
+        u32 peek(const size_t bits);
+        void consume(const size_t bits);
+
     private:
+        void refill(const size_t bits);
+
         bool dirty;
     };
 
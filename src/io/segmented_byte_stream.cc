@@ -0,0 +1,146 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/segmented_byte_stream.h"
+#include <algorithm>
+
+using namespace au;
+using namespace au::io;
+
+SegmentedByteStream::SegmentedByteStream()
+    : SegmentedByteStream(std::make_shared<std::vector<Segment>>())
+{
+}
+
+SegmentedByteStream::SegmentedByteStream(
+    const std::shared_ptr<std::vector<Segment>> segments) :
+        segments(segments),
+        stream_pos(0),
+        open_segment_index(0)
+{
+}
+
+SegmentedByteStream::~SegmentedByteStream()
+{
+}
+
+void SegmentedByteStream::add_segment(
+    const uoff_t size, const SegmentFactory factory)
+{
+    segments->push_back({SegmentedByteStream::size(), size, factory});
+}
+
+void SegmentedByteStream::seek_impl(const uoff_t offset)
+{
+    if (offset > size())
+        throw err::EofError();
+    stream_pos = offset;
+}
+
+void SegmentedByteStream::read_impl(void *destination, const size_t size)
+{
+    read_at_impl(stream_pos, destination, size);
+    stream_pos += size;
+}
+
+void SegmentedByteStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
+{
+    if (offset > this->size() || size > this->size() - offset)
+        throw err::EofError();
+    if (!size)
+        return;
+
+    // first segment that ends past the offset
+    size_t index = std::upper_bound(
+        segments->begin(),
+        segments->end(),
+        offset,
+        [](const uoff_t offset, const Segment &segment)
+        {
+            return offset < segment.offset + segment.size;
+        }) - segments->begin();
+
+    auto destination_ptr = static_cast<u8*>(destination);
+    auto segment_offset = offset - (*segments)[index].offset;
+    size_t left = size;
+    while (left)
+    {
+        const auto &segment = (*segments)[index];
+        const auto chunk_size
+            = std::min<uoff_t>(left, segment.size - segment_offset);
+        auto segment_stream = acquire_segment(index);
+        segment_stream->read_at(segment_offset, destination_ptr, chunk_size);
+        release_segment(index, std::move(segment_stream));
+        destination_ptr += chunk_size;
+        left -= chunk_size;
+        segment_offset = 0;
+        index++;
+    }
+}
+
+std::unique_ptr<io::BaseByteStream> SegmentedByteStream::acquire_segment(
+    const size_t index)
+{
+    {
+        std::lock_guard<std::mutex> lock(open_segment_mutex);
+        if (open_segment && open_segment_index == index)
+            return std::move(open_segment);
+    }
+    auto segment_stream = (*segments)[index].factory();
+    if (segment_stream->size() != (*segments)[index].size)
+        throw err::BadDataSizeError();
+    return segment_stream;
+}
+
+void SegmentedByteStream::release_segment(
+    const size_t index, std::unique_ptr<BaseByteStream> segment_stream)
+{
+    std::lock_guard<std::mutex> lock(open_segment_mutex);
+    open_segment = std::move(segment_stream);
+    open_segment_index = index;
+}
+
+void SegmentedByteStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Not implemented");
+}
+
+uoff_t SegmentedByteStream::pos() const
+{
+    return stream_pos;
+}
+
+uoff_t SegmentedByteStream::size() const
+{
+    return segments->empty()
+        ? 0
+        : segments->back().offset + segments->back().size;
+}
+
+void SegmentedByteStream::resize_impl(const uoff_t new_size)
+{
+    throw err::NotSupportedError("Not implemented");
+}
+
+std::unique_ptr<io::BaseByteStream> SegmentedByteStream::clone() const
+{
+    auto ret = std::unique_ptr<SegmentedByteStream>(
+        new SegmentedByteStream(segments));
+    ret->seek(pos());
+    return ret;
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "err.h"
+#include "io/base_byte_stream.h"
+
+namespace au {
+namespace io {
+
+    // Read-only concatenation of segments whose contents are produced on
+    // demand, one segment at a time. Lets archive decoders hand out entries
+    // made of several chunks without holding the whole entry in memory.
+    class SegmentedByteStream final : public BaseByteStream
+    {
+    public:
+        using SegmentFactory = std::function<std::unique_ptr<BaseByteStream>()>;
+
+        SegmentedByteStream();
+        ~SegmentedByteStream();
+
+        // The stream returned by the factory must be exactly size bytes long.
+        // Segments must all be added before the stream is read or cloned.
+        void add_segment(const uoff_t size, const SegmentFactory factory);
+
+        uoff_t size() const override;
+        uoff_t pos() const override;
+        std::unique_ptr<BaseByteStream> clone() const override;
+
+    protected:
+        void read_impl(void *destination, const size_t size) override;
+        void read_at_impl(
+            const uoff_t offset,
+            void *destination,
+            const size_t size) override;
+        void write_impl(const void *source, const size_t size) override;
+        void seek_impl(const uoff_t offset) override;
+        void resize_impl(const uoff_t new_size) override;
+
+    private:
+        struct Segment final
+        {
+            uoff_t offset;
+            uoff_t size;
+            SegmentFactory factory;
+        };
+
+        SegmentedByteStream(
+            const std::shared_ptr<std::vector<Segment>> segments);
+
+        std::unique_ptr<BaseByteStream> acquire_segment(const size_t index);
+        void release_segment(
+            const size_t index, std::unique_ptr<BaseByteStream> segment);
+
+        std::shared_ptr<std::vector<Segment>> segments;
+        uoff_t stream_pos;
+
+        // the last segment read is kept open for the next read; concurrent
+        // readers take it out while they use it and open their own otherwise
+        std::mutex open_segment_mutex;
+        size_t open_segment_index;
+        std::unique_ptr<BaseByteStream> open_segment;
+    };
+
+} }
@@ -16,7 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/slice_byte_stream.h"
-#include <cstring>
+#include <algorithm>
 
 using namespace au;
 using namespace au::io;
@@ -32,12 +32,33 @@ SliceByteStream::SliceByteStream(
     io::BaseByteStream &parent_stream,
     const uoff_t slice_offset,
     const uoff_t slice_size) :
-        parent_stream(parent_stream.clone()),
         slice_offset(slice_offset),
-        slice_size(slice_size)
+        slice_size(slice_size),
+        slice_pos(0)
 {
     if (slice_size > parent_stream.size() - slice_offset)
         throw err::BadDataSizeError();
+
+    // slices of slices read from the original stream directly
+    const auto parent_slice = dynamic_cast<SliceByteStream*>(&parent_stream);
+    if (parent_slice)
+    {
+        this->parent_stream = parent_slice->parent_stream;
+        this->slice_offset += parent_slice->slice_offset;
+    }
+    else
+        this->parent_stream = parent_stream.clone();
+}
+
+SliceByteStream::SliceByteStream(
+    const std::shared_ptr<io::BaseByteStream> parent_stream,
+    const uoff_t slice_offset,
+    const uoff_t slice_size) :
+        parent_stream(parent_stream),
+        slice_offset(slice_offset),
+        slice_size(slice_size),
+        slice_pos(0)
+{
 }
 
 SliceByteStream::~SliceByteStream()
@@ -46,13 +67,23 @@ SliceByteStream::~SliceByteStream()
 
 void SliceByteStream::seek_impl(const uoff_t offset)
 {
-    parent_stream->seek(slice_offset + offset);
+    if (offset > slice_size)
+        throw err::EofError();
+    slice_pos = offset;
 }
 
 void SliceByteStream::read_impl(void *destination, const size_t size)
 {
-    const auto chunk = parent_stream->read(size);
-    std::memcpy(destination, chunk.get<u8>(), size);
+    read_at_impl(slice_pos, destination, size);
+    slice_pos += size;
+}
+
+void SliceByteStream::read_at_impl(
+    const uoff_t offset, void *destination, const size_t size)
+{
+    if (offset > slice_size || size > slice_size - offset)
+        throw err::EofError();
+    parent_stream->read_at(slice_offset + offset, destination, size);
 }
 
 void SliceByteStream::write_impl(const void *source, const size_t size)
@@ -62,7 +93,7 @@ void SliceByteStream::write_impl(const void *source, const size_t size)
 
 uoff_t SliceByteStream::pos() const
 {
-    return parent_stream->pos() - slice_offset;
+    return slice_pos;
 }
 
 uoff_t SliceByteStream::size() const
@@ -70,6 +101,36 @@ uoff_t SliceByteStream::size() const
     return slice_size;
 }
 
+const io::BaseByteStream &SliceByteStream::get_parent_stream() const
+{
+    return *parent_stream;
+}
+
+bool SliceByteStream::get_file_range(FileRange &range) const
+{
+    if (!parent_stream->get_file_range(range))
+        return false;
+    range.offset += slice_offset;
+    range.size = slice_size;
+    return true;
+}
+
+void SliceByteStream::prefetch(const uoff_t offset, const uoff_t size)
+{
+    if (offset >= slice_size)
+        return;
+    parent_stream->prefetch(
+        slice_offset + offset, std::min(size, slice_size - offset));
+}
+
+const u8 *SliceByteStream::get_view(
+    const uoff_t offset, const size_t size) const
+{
+    if (offset > slice_size || size > slice_size - offset)
+        return nullptr;
+    return parent_stream->get_view(slice_offset + offset, size);
+}
+
 void SliceByteStream::resize_impl(const uoff_t new_size)
 {
     throw err::NotSupportedError("Not implemented");
@@ -77,8 +138,8 @@ void SliceByteStream::resize_impl(const uoff_t new_size)
 
 std::unique_ptr<io::BaseByteStream> SliceByteStream::clone() const
 {
-    auto ret = std::make_unique<SliceByteStream>(
-        *parent_stream, slice_offset, slice_size);
+    auto ret = std::unique_ptr<SliceByteStream>(
+        new SliceByteStream(parent_stream, slice_offset, slice_size));
     ret->seek(pos());
     return std::move(ret);
 }
@@ -24,6 +24,9 @@
 namespace au {
 namespace io {
 
+    // Window into another stream. Reads go straight to the parent stream
+    // through positional reads, so clones and nested slices share a single
+    // copy of the parent.
     class SliceByteStream final : public BaseByteStream
     {
     public:
@@ -36,18 +39,35 @@ namespace io {
 
         uoff_t size() const override;
         uoff_t pos() const override;
+        bool get_file_range(FileRange &range) const override;
+        void prefetch(const uoff_t offset, const uoff_t size) override;
+        const u8 *get_view(
+            const uoff_t offset, const size_t size) const override;
         std::unique_ptr<BaseByteStream> clone() const override;
 
+        // The stream the data is read from, which the slice keeps alive.
+        const io::BaseByteStream &get_parent_stream() const;
+
     protected:
         void read_impl(void *destination, const size_t size) override;
+        void read_at_impl(
+            const uoff_t offset,
+            void *destination,
+            const size_t size) override;
         void write_impl(const void *source, const size_t size) override;
         void seek_impl(const uoff_t offset) override;
         void resize_impl(const uoff_t new_size) override;
 
     private:
-        std::unique_ptr<io::BaseByteStream> parent_stream;
-        const uoff_t slice_offset;
+        SliceByteStream(
+            const std::shared_ptr<io::BaseByteStream> parent_stream,
+            const uoff_t slice_offset,
+            const uoff_t slice_size);
+
+        std::shared_ptr<io::BaseByteStream> parent_stream;
+        uoff_t slice_offset;
         const uoff_t slice_size;
+        uoff_t slice_pos;
     };
 
 } }
@@ -47,6 +47,8 @@ static std::string get_ansi_color(const Logger::Color c)
 
 void Logger::set_color(const Logger::Color c)
 {
+    if (!colors_enabled())
+        return;
     if (isatty(STDIN_FILENO))
         std::cout << get_ansi_color(c);
     if (isatty(STDERR_FILENO))
@@ -75,6 +75,8 @@ static WORD get_win_color(const Logger::Color c)
 
 void Logger::set_color(const Logger::Color c)
 {
+    if (!colors_enabled())
+        return;
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, get_win_color(c));
 }
@@ -17,15 +17,153 @@
 
 #include "res/image.h"
 #include <algorithm>
+#include <cstring>
 #include "algo/format.h"
 #include "algo/range.h"
 #include "err.h"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define IMAGE_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
 using namespace au;
 using namespace au::res;
 
 static const Pixel transparent_pixel = {0, 0, 0, 0};
 
+// The routines below work on spans of pixels, which are packed BGRA words.
+static_assert(sizeof(Pixel) == 4, "Pixels must be packed");
+
+#ifdef IMAGE_USE_SSE2
+
+    // Applies given operation to 4 pixels at a time and hands the rest over
+    // to the scalar version.
+    template<typename VectorOp, typename ScalarOp> static inline void
+        transform_span(
+            Pixel *target_ptr,
+            const Pixel *source_ptr,
+            const size_t count,
+            VectorOp vector_op,
+            ScalarOp scalar_op)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const auto target = reinterpret_cast<__m128i*>(target_ptr + i);
+            const auto source = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(source_ptr + i));
+            _mm_storeu_si128(
+                target, vector_op(_mm_loadu_si128(target), source));
+        }
+        for (; i < count; i++)
+            scalar_op(target_ptr[i], source_ptr[i]);
+    }
+
+#else
+
+    template<typename VectorOp, typename ScalarOp> static inline void
+        transform_span(
+            Pixel *target_ptr,
+            const Pixel *source_ptr,
+            const size_t count,
+            VectorOp,
+            ScalarOp scalar_op)
+    {
+        for (const auto i : algo::range(count))
+            scalar_op(target_ptr[i], source_ptr[i]);
+    }
+
+#endif
+
+#ifdef IMAGE_USE_SSE2
+    #define VECTOR_OP(body) \
+        [](const __m128i target, const __m128i source) { body }
+#else
+    #define VECTOR_OP(body) nullptr
+#endif
+
+static void invert_span(Pixel *target_ptr, const size_t count)
+{
+    transform_span(
+        target_ptr,
+        target_ptr,
+        count,
+        VECTOR_OP(
+            return _mm_xor_si128(target, _mm_set1_epi32(0x00FFFFFF));
+        ),
+        [](Pixel &target, const Pixel &)
+        {
+            target.r ^= 0xFF;
+            target.g ^= 0xFF;
+            target.b ^= 0xFF;
+        });
+}
+
+// Takes the alpha channel from the source's red channel.
+static void mask_span(
+    Pixel *target_ptr, const Pixel *source_ptr, const size_t count)
+{
+    transform_span(
+        target_ptr,
+        source_ptr,
+        count,
+        VECTOR_OP(
+            return _mm_or_si128(
+                _mm_and_si128(target, _mm_set1_epi32(0x00FFFFFF)),
+                _mm_slli_epi32(
+                    _mm_and_si128(source, _mm_set1_epi32(0x00FF0000)), 8));
+        ),
+        [](Pixel &target, const Pixel &source)
+        {
+            target.a = source.r;
+        });
+}
+
+static void overlay_non_transparent_span(
+    Pixel *target_ptr, const Pixel *source_ptr, const size_t count)
+{
+    transform_span(
+        target_ptr,
+        source_ptr,
+        count,
+        VECTOR_OP(
+            const auto is_transparent = _mm_cmpeq_epi32(
+                _mm_and_si128(source, _mm_set1_epi32(0xFF000000)),
+                _mm_setzero_si128());
+            return _mm_or_si128(
+                _mm_and_si128(is_transparent, target),
+                _mm_andnot_si128(is_transparent, source));
+        ),
+        [](Pixel &target, const Pixel &source)
+        {
+            if (source.a)
+                target = source;
+        });
+}
+
+static void overlay_add_span(
+    Pixel *target_ptr, const Pixel *source_ptr, const size_t count)
+{
+    transform_span(
+        target_ptr,
+        source_ptr,
+        count,
+        VECTOR_OP(
+            return _mm_add_epi8(
+                target, _mm_and_si128(source, _mm_set1_epi32(0x00FFFFFF)));
+        ),
+        [](Pixel &target, const Pixel &source)
+        {
+            target.r += source.r;
+            target.g += source.g;
+            target.b += source.b;
+        });
+}
+
+#undef VECTOR_OP
+
 Image::Image(const Image &other) : Grid(other)
 {
 }
@@ -44,20 +182,28 @@ Image::Image(
         throw err::BadDataSizeError();
     if (!width || !height)
         throw err::BadDataSizeError();
-    read_pixels(input.get<const u8>(), content, fmt);
+    read_pixels(input.get<const u8>(), content.data(), content.size(), fmt);
 }
 
 Image::Image(
     const size_t width,
     const size_t height,
     io::BaseByteStream &input_stream,
-    const PixelFormat fmt) :
-        Image(
-            width,
-            height,
-            input_stream.read(width * height * pixel_format_to_bpp(fmt)),
-            fmt)
+    const PixelFormat fmt) : Image(width, height)
 {
+    // Convert straight from the stream's memory when it allows it, rather
+    // than copying the whole payload first.
+    const auto size = width * height * pixel_format_to_bpp(fmt);
+    bstr input;
+    const u8 *input_ptr = input_stream.get_view(input_stream.pos(), size);
+    if (input_ptr)
+        input_stream.skip(size);
+    else
+    {
+        input = input_stream.read(size);
+        input_ptr = input.get<const u8>();
+    }
+    read_pixels(input_ptr, content.data(), content.size(), fmt);
 }
 
 Image::Image(
@@ -82,24 +228,16 @@ Image::Image(
 
 Image &Image::invert()
 {
-    for (const auto y : algo::range(_height))
-    for (const auto x : algo::range(_width))
-    {
-        at(x, y).r ^= 0xFF;
-        at(x, y).g ^= 0xFF;
-        at(x, y).b ^= 0xFF;
-    }
+    invert_span(content.data(), content.size());
     return *this;
 }
 
 Image &Image::flip_vertically()
 {
     for (const auto y : algo::range(_height >> 1))
-    for (const auto x : algo::range(_width))
     {
-        const auto t = at(x, _height - 1 - y);
-        at(x, _height - 1 - y) = at(x, y);
-        at(x, y) = t;
+        std::swap_ranges(
+            &at(0, y), &at(0, y) + _width, &at(0, _height - 1 - y));
     }
     return *this;
 }
@@ -107,45 +245,39 @@ Image &Image::flip_vertically()
 Image &Image::flip_horizontally()
 {
     for (const auto y : algo::range(_height))
-    for (const auto x : algo::range(_width >> 1))
-    {
-        const auto t = at(_width - 1 - x, y);
-        at(_width - 1 - x, y) = at(x, y);
-        at(x, y) = t;
-    }
+        std::reverse(&at(0, y), &at(0, y) + _width);
     return *this;
 }
 
 Image &Image::offset(const int x_offset, const int y_offset)
 {
-    res::Image old_image(*this);
-    crop(_width + x_offset, _height + y_offset);
-    for (auto &c : content)
-        c = transparent_pixel;
+    const auto new_width = static_cast<int>(_width) + x_offset;
+    const auto new_height = static_cast<int>(_height) + y_offset;
+    if (new_width <= 0 || new_height <= 0)
+        throw err::BadDataSizeError();
+    const res::Image old_image(*this);
+    _width = new_width;
+    _height = new_height;
+    content.assign(_width * _height, transparent_pixel);
     return overlay(old_image, x_offset, y_offset, OverlayKind::OverwriteAll);
 }
 
 Image &Image::crop(const size_t new_width, const size_t new_height)
 {
-    std::vector<Pixel> old_content(content.begin(), content.end());
     if (!new_width || !new_height)
         throw err::BadDataSizeError();
-    const auto old_width = _width;
-    const auto old_height = _height;
-    _width = new_width;
-    _height = new_height;
-    content.resize(new_width * new_height);
-    for (const auto y : algo::range(std::min(old_height, new_height)))
-    for (const auto x : algo::range(std::min(old_width, new_width)))
+    decltype(content) new_content(new_width * new_height, transparent_pixel);
+    const auto copied_width = std::min(_width, new_width);
+    for (const auto y : algo::range(std::min(_height, new_height)))
     {
-        content[y * new_width + x] = old_content[y * old_width + x];
+        std::memcpy(
+            &new_content[y * new_width],
+            &at(0, y),
+            copied_width * sizeof(Pixel));
     }
-    for (const auto y : algo::range(old_height, new_height))
-    for (const auto x : algo::range(new_width))
-        content[y * new_width + x] = transparent_pixel;
-    for (const auto y : algo::range(old_height))
-    for (const auto x : algo::range(old_width, new_width))
-        content[y * new_width + x] = transparent_pixel;
+    content.swap(new_content);
+    _width = new_width;
+    _height = new_height;
     return *this;
 }
 
@@ -153,19 +285,22 @@ Image &Image::apply_mask(const Image &other)
 {
     if (other.width() != _width || other.height() != _height)
         throw std::logic_error("Mask image size is different from image size");
-    for (const auto y : algo::range(_height))
-    for (const auto x : algo::range(_width))
-        at(x, y).a = other.at(x, y).r;
+    mask_span(content.data(), other.begin(), content.size());
     return *this;
 }
 
 Image &Image::apply_palette(const Palette &palette)
 {
-    const auto palette_size = palette.size();
+    // Pixel indices are 8-bit, so the palette always fits a flat table,
+    // which spares the per-pixel calls into Palette.
+    Pixel table[256];
+    const auto palette_size = std::min<size_t>(palette.size(), 256);
+    for (const auto i : algo::range(palette_size))
+        table[i] = palette[i];
     for (auto &c : content)
     {
         if (c.r < palette_size)
-            c = palette[c.r];
+            c = table[c.r];
         else
             c.a = 0;
     }
@@ -191,37 +326,26 @@ Image &Image::overlay(
     const int y2 = std::min<int>(height(), target_y + other.height());
     const int source_x = -target_x;
     const int source_y = -target_y;
-    if (overlay_kind == OverlayKind::OverwriteAll)
-    {
-        for (const auto y : algo::range(y1, y2))
-        for (const auto x : algo::range(x1, x2))
-            at(x, y) = other.at(source_x + x, source_y + y);
-    }
-    else if (overlay_kind == OverlayKind::OverwriteNonTransparent)
-    {
-        for (const auto y : algo::range(y1, y2))
-        for (const auto x : algo::range(x1, x2))
-        {
-            const auto &source_pixel = other.at(source_x + x, source_y + y);
-            if (source_pixel.a)
-                at(x, y) = source_pixel;
-        }
-    }
-    else if (overlay_kind == OverlayKind::AddSimple)
+    if (overlay_kind != OverlayKind::OverwriteAll
+        && overlay_kind != OverlayKind::OverwriteNonTransparent
+        && overlay_kind != OverlayKind::AddSimple)
     {
-        for (const auto y : algo::range(y1, y2))
-        for (const auto x : algo::range(x1, x2))
-        {
-            auto &target_pixel = at(x, y);
-            const auto &source_pixel = other.at(source_x + x, source_y + y);
-            target_pixel.r += source_pixel.r;
-            target_pixel.g += source_pixel.g;
-            target_pixel.b += source_pixel.b;
-        }
+        throw std::logic_error("Unknown overlay kind");
     }
-    else
+    if (x1 >= x2)
+        return *this;
+
+    const size_t span_size = x2 - x1;
+    for (const auto y : algo::range(y1, y2))
     {
-        throw std::logic_error("Unknown overlay kind");
+        auto target_ptr = &at(x1, y);
+        const auto source_ptr = &other.at(source_x + x1, source_y + y);
+        if (overlay_kind == OverlayKind::OverwriteAll)
+            std::memmove(target_ptr, source_ptr, span_size * sizeof(Pixel));
+        else if (overlay_kind == OverlayKind::OverwriteNonTransparent)
+            overlay_non_transparent_span(target_ptr, source_ptr, span_size);
+        else
+            overlay_add_span(target_ptr, source_ptr, span_size);
     }
     return *this;
 }
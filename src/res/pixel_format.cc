@@ -20,6 +20,22 @@
 #include "algo/format.h"
 #include "algo/range.h"
 
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PIXEL_FORMAT_USE_SSE2
+    #include <emmintrin.h>
+    #if defined(_MSC_VER)
+        #define PIXEL_FORMAT_USE_SSSE3
+        #define SSSE3_FUNCTION
+        #include <intrin.h>
+        #include <tmmintrin.h>
+    #elif defined(__GNUC__)
+        #define PIXEL_FORMAT_USE_SSSE3
+        #define SSSE3_FUNCTION __attribute__((target("ssse3")))
+        #include <tmmintrin.h>
+    #endif
+#endif
+
 namespace au {
 namespace res {
 
@@ -255,47 +271,328 @@ namespace res {
         return c;
     }
 
-    void read_pixels(
-        const u8 *input_ptr, std::vector<Pixel> &output, const PixelFormat fmt)
+} }
+
+using namespace au;
+using namespace au::res;
+
+namespace
+{
+    using ReadPixelsFunc = void (*)(const u8 *, Pixel *, const size_t);
+
+    enum class Alpha : u8
+    {
+        Opaque,
+        Nibble,
+        InvertedNibble,
+        Bit,
+        InvertedBit,
+    };
+}
+
+#ifdef PIXEL_FORMAT_USE_SSE2
+
+    // Moves the masked bits of each 16-bit lane by given amount; positive
+    // amounts shift left.
+    template<u16 mask, int shift> static inline __m128i extract_16(
+        const __m128i input)
+    {
+        const auto masked = _mm_and_si128(
+            input, _mm_set1_epi16(static_cast<short>(mask)));
+        return shift >= 0
+            ? _mm_slli_epi16(masked, shift & 15)
+            : _mm_srli_epi16(masked, -shift & 15);
+    }
+
+    // 16-bit formats: 8 pixels per iteration. Channels are extracted into
+    // 16-bit lanes and then interleaved into BGRA.
+    template<
+        PixelFormat fmt,
+        bool is_rgb,
+        u16 mask0, int shift0,
+        u16 mask1, int shift1,
+        u16 mask2, int shift2,
+        Alpha alpha>
+    static void read_pixels_16_sse2(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const auto input = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(input_ptr + i * 2));
+            const auto c0 = extract_16<mask0, shift0>(input);
+            const auto c1 = extract_16<mask1, shift1>(input);
+            const auto c2 = extract_16<mask2, shift2>(input);
+            __m128i a;
+            switch (alpha)
+            {
+                case Alpha::Opaque:
+                    a = _mm_set1_epi16(0xFF);
+                    break;
+                case Alpha::Nibble:
+                case Alpha::InvertedNibble:
+                    a = extract_16<0b11110000'00000000, -8>(input);
+                    break;
+                case Alpha::Bit:
+                case Alpha::InvertedBit:
+                    a = _mm_srli_epi16(_mm_srai_epi16(input, 15), 8);
+                    break;
+            }
+            if (alpha == Alpha::InvertedNibble || alpha == Alpha::InvertedBit)
+                a = _mm_xor_si128(a, _mm_set1_epi16(0xFF));
+            const auto b = is_rgb ? c2 : c0;
+            const auto r = is_rgb ? c0 : c2;
+            const auto bg = _mm_or_si128(b, _mm_slli_epi16(c1, 8));
+            const auto ra = _mm_or_si128(r, _mm_slli_epi16(a, 8));
+            const auto output = reinterpret_cast<__m128i*>(output_ptr + i);
+            _mm_storeu_si128(output, _mm_unpacklo_epi16(bg, ra));
+            _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(bg, ra));
+        }
+        read_pixels<fmt>(input_ptr + i * 2, output_ptr + i, count - i);
+    }
+
+    // 32-bit formats: 4 pixels per iteration.
+    template<PixelFormat fmt, bool is_rgb, bool force_alpha, bool invert_alpha>
+    static void read_pixels_32_sse2(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            auto pixels = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(input_ptr + i * 4));
+            if (is_rgb)
+            {
+                const auto ga = _mm_and_si128(
+                    pixels, _mm_set1_epi32(0xFF00FF00));
+                const auto rb = _mm_and_si128(
+                    pixels, _mm_set1_epi32(0x00FF00FF));
+                pixels = _mm_or_si128(
+                    ga,
+                    _mm_or_si128(
+                        _mm_srli_epi32(rb, 16),
+                        _mm_and_si128(
+                            _mm_slli_epi32(rb, 16),
+                            _mm_set1_epi32(0x00FF0000))));
+            }
+            if (force_alpha)
+                pixels = _mm_or_si128(pixels, _mm_set1_epi32(0xFF000000));
+            if (invert_alpha)
+                pixels = _mm_xor_si128(pixels, _mm_set1_epi32(0xFF000000));
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(output_ptr + i), pixels);
+        }
+        read_pixels<fmt>(input_ptr + i * 4, output_ptr + i, count - i);
+    }
+
+    static void read_gray_pixels_sse2(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
     {
-        // save those precious CPU cycles
-        if (fmt == PixelFormat::BGRA8888)
+        const auto opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const auto gray = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(input_ptr + i));
+            const auto gg_lo = _mm_unpacklo_epi8(gray, gray);
+            const auto gg_hi = _mm_unpackhi_epi8(gray, gray);
+            const auto ga_lo = _mm_unpacklo_epi8(gray, opaque);
+            const auto ga_hi = _mm_unpackhi_epi8(gray, opaque);
+            const auto output = reinterpret_cast<__m128i*>(output_ptr + i);
+            _mm_storeu_si128(output, _mm_unpacklo_epi16(gg_lo, ga_lo));
+            _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(gg_lo, ga_lo));
+            _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(gg_hi, ga_hi));
+            _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(gg_hi, ga_hi));
+        }
+        read_pixels<PixelFormat::Gray8>(
+            input_ptr + i, output_ptr + i, count - i);
+    }
+
+    #ifdef PIXEL_FORMAT_USE_SSSE3
+
+        static bool has_ssse3()
         {
-            std::memcpy(output.data(), input_ptr, output.size() * 4);
-            return;
+            #ifdef _MSC_VER
+                int info[4];
+                __cpuid(info, 1);
+                return (info[2] & (1 << 9)) != 0;
+            #else
+                return __builtin_cpu_supports("ssse3");
+            #endif
         }
 
-        // I don't think there is a better alternative to this
-        using PF = PixelFormat;
-        std::function<void(const u8 *, std::vector<Pixel> &)> impl;
+        // 24-bit formats: 4 pixels per iteration, spread with a shuffle.
+        template<PixelFormat fmt, bool is_rgb> SSSE3_FUNCTION
+            static void read_pixels_24_ssse3(
+                const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+        {
+            const auto shuffle = is_rgb
+                ? _mm_setr_epi8(
+                    2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                : _mm_setr_epi8(
+                    0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            const auto opaque = _mm_set1_epi32(0xFF000000);
+            size_t i = 0;
+            // each load takes 16 bytes, but only 12 of them get used
+            for (; i + 6 <= count; i += 4)
+            {
+                const auto input = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(input_ptr + i * 3));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output_ptr + i),
+                    _mm_or_si128(_mm_shuffle_epi8(input, shuffle), opaque));
+            }
+            read_pixels<fmt>(input_ptr + i * 3, output_ptr + i, count - i);
+        }
+
+    #endif
+
+#endif
+
+// BGRA8888 is already how res::Pixel is laid out
+static void copy_pixels(
+    const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+{
+    std::memcpy(output_ptr, input_ptr, count * 4);
+}
+
+static ReadPixelsFunc get_read_pixels_func(const PixelFormat fmt)
+{
+    using PF = PixelFormat;
+    #ifdef PIXEL_FORMAT_USE_SSE2
+        const auto B = false;
+        const auto R = true;
         switch (fmt)
         {
-            case PF::Gray8:     impl = read_pixels<PF::Gray8>; break;
-            case PF::BGR555X:   impl = read_pixels<PF::BGR555X>; break;
-            case PF::BGR565:    impl = read_pixels<PF::BGR565>; break;
-            case PF::BGR888:    impl = read_pixels<PF::BGR888>; break;
-            case PF::BGR888X:   impl = read_pixels<PF::BGR888X>; break;
-            case PF::BGRA4444:  impl = read_pixels<PF::BGRA4444>; break;
-            case PF::BGRA5551:  impl = read_pixels<PF::BGRA5551>; break;
-            case PF::BGRA8888:  impl = read_pixels<PF::BGRA8888>; break;
-            case PF::BGRnA4444: impl = read_pixels<PF::BGRnA4444>; break;
-            case PF::BGRnA5551: impl = read_pixels<PF::BGRnA5551>; break;
-            case PF::BGRnA8888: impl = read_pixels<PF::BGRnA8888>; break;
-            case PF::RGB555X:   impl = read_pixels<PF::RGB555X>; break;
-            case PF::RGB565:    impl = read_pixels<PF::RGB565>; break;
-            case PF::RGB888:    impl = read_pixels<PF::RGB888>; break;
-            case PF::RGB888X:   impl = read_pixels<PF::RGB888X>; break;
-            case PF::RGBA4444:  impl = read_pixels<PF::RGBA4444>; break;
-            case PF::RGBA5551:  impl = read_pixels<PF::RGBA5551>; break;
-            case PF::RGBA8888:  impl = read_pixels<PF::RGBA8888>; break;
-            case PF::RGBnA4444: impl = read_pixels<PF::RGBnA4444>; break;
-            case PF::RGBnA5551: impl = read_pixels<PF::RGBnA5551>; break;
-            case PF::RGBnA8888: impl = read_pixels<PF::RGBnA8888>; break;
+            case PF::Gray8:
+                return &read_gray_pixels_sse2;
+
+            case PF::BGR555X:
+                return &read_pixels_16_sse2<PF::BGR555X, B,
+                    0b00000000'00011111, 3,
+                    0b00000011'11100000, -2,
+                    0b01111100'00000000, -7, Alpha::Opaque>;
+            case PF::BGR565:
+                return &read_pixels_16_sse2<PF::BGR565, B,
+                    0b00000000'00011111, 3,
+                    0b00000111'11100000, -3,
+                    0b11111000'00000000, -8, Alpha::Opaque>;
+            case PF::BGRA4444:
+                return &read_pixels_16_sse2<PF::BGRA4444, B,
+                    0b00000000'00001111, 4,
+                    0b00000000'11110000, 0,
+                    0b00001111'00000000, -4, Alpha::Nibble>;
+            case PF::BGRA5551:
+                return &read_pixels_16_sse2<PF::BGRA5551, B,
+                    0b00000000'00011111, 3,
+                    0b00000011'11100000, -2,
+                    0b01111100'00000000, -7, Alpha::Bit>;
+            case PF::BGRnA4444:
+                return &read_pixels_16_sse2<PF::BGRnA4444, B,
+                    0b00000000'00001111, 4,
+                    0b00000000'11110000, 0,
+                    0b00001111'00000000, -4, Alpha::InvertedNibble>;
+            case PF::BGRnA5551:
+                return &read_pixels_16_sse2<PF::BGRnA5551, B,
+                    0b00000000'00011111, 3,
+                    0b00000011'11100000, -2,
+                    0b01111100'00000000, -7, Alpha::InvertedBit>;
+
+            case PF::RGB555X:
+                return &read_pixels_16_sse2<PF::RGB555X, R,
+                    0b00000000'00011111, 3,
+                    0b00000011'11100000, -2,
+                    0b01111100'00000000, -7, Alpha::Opaque>;
+            case PF::RGB565:
+                return &read_pixels_16_sse2<PF::RGB565, R,
+                    0b00000000'00011111, 3,
+                    0b00000111'11100000, -3,
+                    0b11111000'00000000, -8, Alpha::Opaque>;
+            case PF::RGBA4444:
+                return &read_pixels_16_sse2<PF::RGBA4444, R,
+                    0b00000000'00001111, 4,
+                    0b00000000'11110000, 0,
+                    0b00001111'00000000, -4, Alpha::Nibble>;
+            case PF::RGBA5551:
+                return &read_pixels_16_sse2<PF::RGBA5551, R,
+                    0b00000000'00011111, 3,
+                    0b00000011'11100000, -2,
+                    0b01111100'00000000, -7, Alpha::Bit>;
+            case PF::RGBnA4444:
+                return &read_pixels_16_sse2<PF::RGBnA4444, R,
+                    0b00000000'00001111, 4,
+                    0b00000000'11110000, 0,
+                    0b00001111'00000000, -4, Alpha::InvertedNibble>;
+            case PF::RGBnA5551:
+                return &read_pixels_16_sse2<PF::RGBnA5551, R,
+                    0b00000000'00011111, 3,
+                    0b00000011'11100000, -2,
+                    0b01111100'00000000, -7, Alpha::InvertedBit>;
+
+            case PF::BGR888X:
+                return &read_pixels_32_sse2<PF::BGR888X, B, true, false>;
+            case PF::BGRnA8888:
+                return &read_pixels_32_sse2<PF::BGRnA8888, B, false, true>;
+            case PF::RGB888X:
+                return &read_pixels_32_sse2<PF::RGB888X, R, true, false>;
+            case PF::RGBA8888:
+                return &read_pixels_32_sse2<PF::RGBA8888, R, false, false>;
+            case PF::RGBnA8888:
+                return &read_pixels_32_sse2<PF::RGBnA8888, R, false, true>;
+
+            #ifdef PIXEL_FORMAT_USE_SSSE3
+                case PF::BGR888:
+                case PF::RGB888:
+                {
+                    static const bool use_ssse3 = has_ssse3();
+                    if (!use_ssse3)
+                        break;
+                    return fmt == PF::BGR888
+                        ? &read_pixels_24_ssse3<PF::BGR888, B>
+                        : &read_pixels_24_ssse3<PF::RGB888, R>;
+                }
+            #endif
+
             default:
-                throw std::logic_error(
-                    algo::format("Unsupported pixel format: %d", fmt));
+                break;
         }
-        impl(input_ptr, output);
+    #endif
+
+    switch (fmt)
+    {
+        case PF::Gray8:     return &read_pixels<PF::Gray8>;
+        case PF::BGR555X:   return &read_pixels<PF::BGR555X>;
+        case PF::BGR565:    return &read_pixels<PF::BGR565>;
+        case PF::BGR888:    return &read_pixels<PF::BGR888>;
+        case PF::BGR888X:   return &read_pixels<PF::BGR888X>;
+        case PF::BGRA4444:  return &read_pixels<PF::BGRA4444>;
+        case PF::BGRA5551:  return &read_pixels<PF::BGRA5551>;
+        case PF::BGRA8888:  return &copy_pixels;
+        case PF::BGRnA4444: return &read_pixels<PF::BGRnA4444>;
+        case PF::BGRnA5551: return &read_pixels<PF::BGRnA5551>;
+        case PF::BGRnA8888: return &read_pixels<PF::BGRnA8888>;
+        case PF::RGB555X:   return &read_pixels<PF::RGB555X>;
+        case PF::RGB565:    return &read_pixels<PF::RGB565>;
+        case PF::RGB888:    return &read_pixels<PF::RGB888>;
+        case PF::RGB888X:   return &read_pixels<PF::RGB888X>;
+        case PF::RGBA4444:  return &read_pixels<PF::RGBA4444>;
+        case PF::RGBA5551:  return &read_pixels<PF::RGBA5551>;
+        case PF::RGBA8888:  return &read_pixels<PF::RGBA8888>;
+        case PF::RGBnA4444: return &read_pixels<PF::RGBnA4444>;
+        case PF::RGBnA5551: return &read_pixels<PF::RGBnA5551>;
+        case PF::RGBnA8888: return &read_pixels<PF::RGBnA8888>;
+        default:
+            throw std::logic_error(
+                algo::format("Unsupported pixel format: %d", fmt));
     }
+}
 
-} }
+void res::read_pixels(
+    const u8 *input_ptr,
+    Pixel *output_ptr,
+    const size_t count,
+    const PixelFormat fmt)
+{
+    get_read_pixels_func(fmt)(input_ptr, output_ptr, count);
+}
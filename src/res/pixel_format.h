@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "algo/range.h"
 #include "io/base_byte_stream.h"
 #include "res/pixel.h"
 
@@ -84,17 +85,26 @@ namespace res {
     template<PixelFormat fmt> Pixel read_pixel(const u8 *&ptr);
 
     template<PixelFormat fmt> void read_pixels(
-        const u8 *input_ptr, std::vector<Pixel> &output)
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
     {
-        for (auto &c : output)
-            c = read_pixel<fmt>(input_ptr);
+        for (const auto i : algo::range(count))
+            output_ptr[i] = read_pixel<fmt>(input_ptr);
     }
 
     void read_pixels(
         const u8 *input_ptr,
-        std::vector<Pixel> &output,
+        Pixel *output_ptr,
+        const size_t count,
         const PixelFormat fmt);
 
+    inline void read_pixels(
+        const u8 *input_ptr,
+        std::vector<Pixel> &output,
+        const PixelFormat fmt)
+    {
+        read_pixels(input_ptr, output.data(), output.size(), fmt);
+    }
+
     template<PixelFormat fmt> inline Pixel read_pixel(
         io::BaseByteStream &input_stream)
     {
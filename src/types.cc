@@ -17,9 +17,122 @@
 
 #include "types.h"
 #include <algorithm>
+#include <array>
+#include "arena.h"
 
 using namespace au;
 
+// Buffers between 64 KiB and 64 MiB are rounded up to one of four size
+// classes per power of two, so that freed buffers can be reused by later
+// allocations of similar size.
+static const size_t min_pooled_size_log2 = 16;
+static const size_t max_pooled_size_log2 = 26;
+static const size_t size_class_count
+    = (max_pooled_size_log2 - min_pooled_size_log2) * 4;
+static const size_t max_buffers_per_size_class = 4;
+static const size_t max_pooled_size_per_thread = 32 * 1024 * 1024;
+
+namespace
+{
+    struct BufferPool final
+    {
+        ~BufferPool();
+
+        std::array<std::vector<void*>, size_class_count> free_buffers;
+        size_t pooled_size = 0;
+    };
+}
+
+static thread_local BufferPool buffer_pool;
+static thread_local bool buffer_pool_destroyed = false;
+
+BufferPool::~BufferPool()
+{
+    for (const auto &buffers : free_buffers)
+    for (const auto buffer : buffers)
+        ::operator delete(buffer);
+    buffer_pool_destroyed = true;
+}
+
+static bool get_size_class(
+    const size_t size, size_t &size_class, size_t &class_size)
+{
+    if (size <= (1ull << min_pooled_size_log2)
+        || size > (1ull << max_pooled_size_log2))
+    {
+        return false;
+    }
+    size_t log2 = min_pooled_size_log2;
+    while ((2ull << log2) < size)
+        log2++;
+    const size_t base = 1ull << log2;
+    const size_t step = base / 4;
+    const size_t sub_class = (size - base + step - 1) / step;
+    size_class = (log2 - min_pooled_size_log2) * 4 + sub_class - 1;
+    class_size = base + sub_class * step;
+    return true;
+}
+
+static void *allocate_heap_buffer(const size_t size)
+{
+    size_t size_class, class_size;
+    if (!get_size_class(size, size_class, class_size))
+        return ::operator new(Arena::header_size + size);
+    if (!buffer_pool_destroyed)
+    {
+        auto &buffers = buffer_pool.free_buffers[size_class];
+        if (!buffers.empty())
+        {
+            const auto buffer = buffers.back();
+            buffers.pop_back();
+            buffer_pool.pooled_size -= class_size;
+            return buffer;
+        }
+    }
+    return ::operator new(Arena::header_size + class_size);
+}
+
+static void deallocate_heap_buffer(void *buffer, const size_t size)
+{
+    size_t size_class, class_size;
+    if (get_size_class(size, size_class, class_size) && !buffer_pool_destroyed)
+    {
+        auto &buffers = buffer_pool.free_buffers[size_class];
+        if (buffers.size() < max_buffers_per_size_class
+            && buffer_pool.pooled_size + class_size
+                <= max_pooled_size_per_thread)
+        {
+            buffers.push_back(buffer);
+            buffer_pool.pooled_size += class_size;
+            return;
+        }
+    }
+    ::operator delete(buffer);
+}
+
+// Heap buffers carry an empty header so that they can be told apart from the
+// ones served by an arena.
+void *priv::allocate_bstr_buffer(const size_t size)
+{
+    if (const auto arena = Arena::current())
+    {
+        if (const auto ptr = arena->allocate(size))
+            return ptr;
+    }
+    const auto buffer = static_cast<u8*>(allocate_heap_buffer(size));
+    *reinterpret_cast<void**>(buffer) = nullptr;
+    return buffer + Arena::header_size;
+}
+
+void priv::deallocate_bstr_buffer(void *ptr, const size_t size)
+{
+    if (Arena::owns(ptr))
+        Arena::deallocate(ptr);
+    else
+        deallocate_heap_buffer(
+            static_cast<u8*>(ptr) - Arena::header_size, size);
+}
+
 const size_t bstr::npos = static_cast<size_t>(-1);
 
 bstr::bstr()
@@ -138,6 +251,11 @@ void bstr::replace(int start, int size, const bstr &what)
 }
 
 void bstr::resize(const size_t how_much)
+{
+    v.resize(how_much, 0);
+}
+
+void bstr::resize_uninitialized(const size_t how_much)
 {
     v.resize(how_much);
 }
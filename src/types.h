@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace au {
@@ -40,6 +42,60 @@ namespace au {
     using soff_t = s64;
     using uoff_t = u64;
 
+    namespace priv {
+
+        void *allocate_bstr_buffer(const size_t size);
+        void deallocate_bstr_buffer(void *ptr, const size_t size);
+
+        // Unlike std::allocator, leaves elements uninitialized unless given
+        // a value, recycles large buffers freed on the same thread and
+        // serves small ones from the current Arena, if any.
+        template<typename T> struct BstrAllocator
+        {
+            using value_type = T;
+
+            BstrAllocator() = default;
+
+            template<typename U> BstrAllocator(const BstrAllocator<U> &)
+            {
+            }
+
+            T *allocate(const size_t n)
+            {
+                return static_cast<T*>(allocate_bstr_buffer(n * sizeof(T)));
+            }
+
+            void deallocate(T *ptr, const size_t n)
+            {
+                deallocate_bstr_buffer(ptr, n * sizeof(T));
+            }
+
+            template<typename U> void construct(U *ptr)
+            {
+                ::new(static_cast<void*>(ptr)) U;
+            }
+
+            template<typename U, typename... Args>
+                void construct(U *ptr, Args&&... args)
+            {
+                ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+            }
+
+            template<typename U>
+                bool operator ==(const BstrAllocator<U> &) const
+            {
+                return true;
+            }
+
+            template<typename U>
+                bool operator !=(const BstrAllocator<U> &) const
+            {
+                return false;
+            }
+        };
+
+    }
+
     struct bstr final
     {
         static const size_t npos;
@@ -56,6 +112,10 @@ namespace au {
         void resize(const size_t how_much);
         void reserve(const size_t how_much);
 
+        // Like resize(), but doesn't zero the new bytes. Meant for buffers
+        // that are about to be overwritten in full.
+        void resize_uninitialized(const size_t how_much);
+
         size_t find(const bstr &other) const;
         size_t find(const bstr &other, const size_t start_pos) const;
         bstr substr(const int start) const;
@@ -121,7 +181,7 @@ namespace au {
         const u8 &at(const size_t pos) const;
 
     private:
-        std::vector<u8> v;
+        std::vector<u8, priv::BstrAllocator<u8>> v;
     };
 
     constexpr size_t operator "" _z(unsigned long long int value)
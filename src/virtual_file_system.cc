@@ -19,17 +19,130 @@
 #include <map>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 #include "algo/str.h"
 #include "err.h"
 #include "io/file_system.h"
 
 using namespace au;
 
+using FileFactory = std::function<std::unique_ptr<io::File>()>;
+
+namespace
+{
+    using PathIndex = std::unordered_map<std::string, std::set<io::path>>;
+
+    // Listing of a registered directory, read from the disk on first lookup.
+    class DirectoryIndex final
+    {
+    public:
+        DirectoryIndex(const io::path &path);
+
+        bool find_by_stem(const std::string &stem, io::path &result);
+        bool find_by_name(const std::string &name, io::path &result);
+        bool find_by_path(const io::path &path, io::path &result);
+
+    private:
+        void build();
+
+        const io::path path;
+        std::once_flag built;
+        std::unordered_map<std::string, io::path> paths_by_stem;
+        std::unordered_map<std::string, io::path> paths_by_name;
+        std::unordered_map<std::string, io::path> paths_by_path;
+    };
+}
+
 static std::mutex mutex;
-static std::map<io::path, std::function<std::unique_ptr<io::File>()>> factories;
-static std::set<io::path> directories;
+static std::unordered_map<std::string, FileFactory> factories;
+static PathIndex factory_paths_by_stem;
+static PathIndex factory_paths_by_name;
+static std::map<io::path, std::shared_ptr<DirectoryIndex>> directories;
 static bool enabled = true;
 
+static bool find_in(
+    const std::unordered_map<std::string, io::path> &index,
+    const std::string &key,
+    io::path &result)
+{
+    const auto it = index.find(key);
+    if (it == index.end())
+        return false;
+    result = it->second;
+    return true;
+}
+
+DirectoryIndex::DirectoryIndex(const io::path &path) : path(path)
+{
+}
+
+void DirectoryIndex::build()
+{
+    std::call_once(built, [&]()
+    {
+        for (const auto &other_path : io::recursive_directory_range(path))
+        {
+            // first match wins, same as in a plain scan of the listing
+            paths_by_stem.insert({algo::lower(other_path.stem()), other_path});
+            paths_by_name.insert({algo::lower(other_path.name()), other_path});
+            paths_by_path.insert(
+                {io::path(algo::lower(other_path.str())).str(), other_path});
+        }
+    });
+}
+
+bool DirectoryIndex::find_by_stem(const std::string &stem, io::path &result)
+{
+    build();
+    return find_in(paths_by_stem, stem, result);
+}
+
+bool DirectoryIndex::find_by_name(const std::string &name, io::path &result)
+{
+    build();
+    return find_in(paths_by_name, name, result);
+}
+
+bool DirectoryIndex::find_by_path(const io::path &path, io::path &result)
+{
+    build();
+    return find_in(paths_by_path, path.str(), result);
+}
+
+static void add_to_index(
+    PathIndex &index, const std::string &key, const io::path &path)
+{
+    index[key].insert(path);
+}
+
+static void remove_from_index(
+    PathIndex &index, const std::string &key, const io::path &path)
+{
+    const auto it = index.find(key);
+    if (it == index.end())
+        return;
+    it->second.erase(path);
+    if (it->second.empty())
+        index.erase(it);
+}
+
+static FileFactory find_factory(const PathIndex &index, const std::string &key)
+{
+    const auto it = index.find(key);
+    if (it == index.end())
+        return nullptr;
+    return factories.at(it->second.begin()->str());
+}
+
+static std::vector<std::shared_ptr<DirectoryIndex>> get_directories()
+{
+    std::vector<std::shared_ptr<DirectoryIndex>> result;
+    for (const auto &kv : directories)
+        result.push_back(kv.second);
+    return result;
+}
+
 void VirtualFileSystem::disable()
 {
     std::unique_lock<std::mutex> lock(mutex);
@@ -44,8 +157,11 @@ void VirtualFileSystem::enable()
 
 void VirtualFileSystem::clear()
 {
+    std::unique_lock<std::mutex> lock(mutex);
     directories.clear();
     factories.clear();
+    factory_paths_by_stem.clear();
+    factory_paths_by_name.clear();
 }
 
 void VirtualFileSystem::register_file(
@@ -53,21 +169,29 @@ void VirtualFileSystem::register_file(
     const std::function<std::unique_ptr<io::File>()> factory)
 {
     std::unique_lock<std::mutex> lock(mutex);
-    if (enabled)
-        factories[io::path(algo::lower(path.str()))] = factory;
+    if (!enabled)
+        return;
+    const auto key = io::path(algo::lower(path.str()));
+    factories[key.str()] = factory;
+    add_to_index(factory_paths_by_stem, key.stem(), key);
+    add_to_index(factory_paths_by_name, key.name(), key);
 }
 
 void VirtualFileSystem::unregister_file(const io::path &path)
 {
     std::unique_lock<std::mutex> lock(mutex);
-    factories.erase(io::path(algo::lower(path.str())));
+    const auto key = io::path(algo::lower(path.str()));
+    if (!factories.erase(key.str()))
+        return;
+    remove_from_index(factory_paths_by_stem, key.stem(), key);
+    remove_from_index(factory_paths_by_name, key.name(), key);
 }
 
 void VirtualFileSystem::register_directory(const io::path &path)
 {
     std::unique_lock<std::mutex> lock(mutex);
-    if (enabled)
-        directories.insert(path);
+    if (enabled && directories.find(path) == directories.end())
+        directories[path] = std::make_shared<DirectoryIndex>(path);
 }
 
 void VirtualFileSystem::unregister_directory(const io::path &path)
@@ -76,22 +200,32 @@ void VirtualFileSystem::unregister_directory(const io::path &path)
     directories.erase(path);
 }
 
+// The lookups below only hold the lock while consulting the indexes, so
+// that factories (which usually decode an archive entry) and directory
+// listings don't block other threads.
+
 std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
     const std::string &stem)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
-        return nullptr;
-
     const auto check = algo::lower(stem);
-    for (const auto &kv : factories)
-        if (kv.first.stem() == check)
-            return kv.second();
+    FileFactory factory;
+    std::vector<std::shared_ptr<DirectoryIndex>> directories_to_check;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!enabled)
+            return nullptr;
+        factory = find_factory(factory_paths_by_stem, check);
+        if (!factory)
+            directories_to_check = get_directories();
+    }
+
+    if (factory)
+        return factory();
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
-        if (algo::lower(other_path.stem()) == check)
-            return std::make_unique<io::File>(other_path, io::FileMode::Read);
+    io::path result;
+    for (const auto &directory : directories_to_check)
+        if (directory->find_by_stem(check, result))
+            return std::make_unique<io::File>(result, io::FileMode::Read);
 
     return nullptr;
 }
@@ -99,39 +233,52 @@ std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
 std::unique_ptr<io::File> VirtualFileSystem::get_by_name(
     const std::string &name)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
-        return nullptr;
-
     const auto check = algo::lower(name);
-    for (const auto &kv : factories)
-        if (kv.first.name() == check)
-            return kv.second();
+    FileFactory factory;
+    std::vector<std::shared_ptr<DirectoryIndex>> directories_to_check;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!enabled)
+            return nullptr;
+        factory = find_factory(factory_paths_by_name, check);
+        if (!factory)
+            directories_to_check = get_directories();
+    }
 
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
-        if (algo::lower(other_path.name()) == check)
-            return std::make_unique<io::File>(other_path, io::FileMode::Read);
+    if (factory)
+        return factory();
+
+    io::path result;
+    for (const auto &directory : directories_to_check)
+        if (directory->find_by_name(check, result))
+            return std::make_unique<io::File>(result, io::FileMode::Read);
 
     return nullptr;
 }
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_path(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
-        return nullptr;
-
     const auto check = io::path(algo::lower(path.str()));
-    if (factories.find(check) != factories.end())
-        return factories[check]();
-
-    for (const auto &directory : directories)
-    for (const auto &other_path : io::recursive_directory_range(directory))
+    FileFactory factory;
+    std::vector<std::shared_ptr<DirectoryIndex>> directories_to_check;
     {
-        if (io::path(algo::lower(other_path.str())) == check)
-            return std::make_unique<io::File>(other_path, io::FileMode::Read);
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!enabled)
+            return nullptr;
+        const auto it = factories.find(check.str());
+        if (it != factories.end())
+            factory = it->second;
+        else
+            directories_to_check = get_directories();
     }
 
+    if (factory)
+        return factory();
+
+    io::path result;
+    for (const auto &directory : directories_to_check)
+        if (directory->find_by_path(check, result))
+            return std::make_unique<io::File>(result, io::FileMode::Read);
+
     return nullptr;
 }
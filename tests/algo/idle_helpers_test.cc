@@ -0,0 +1,70 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/idle_helpers.h"
+#include <atomic>
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Idle helpers", "[algo]")
+{
+    int call_count = 0;
+    const auto function = [&]() { call_count++; };
+
+    SECTION("Nobody helps when no request is made")
+    {
+        REQUIRE(!algo::has_pending_help_requests());
+        REQUIRE(!algo::help_with_pending_request());
+    }
+
+    SECTION("Requests without helpers are not made")
+    {
+        const algo::HelpRequest help_request(function, 0);
+        REQUIRE(!algo::has_pending_help_requests());
+        REQUIRE(!algo::help_with_pending_request());
+        REQUIRE(call_count == 0);
+    }
+
+    SECTION("No more helpers are sent once the function returns")
+    {
+        {
+            const algo::HelpRequest help_request(function, 2);
+            REQUIRE(algo::has_pending_help_requests());
+            REQUIRE(algo::help_with_pending_request());
+            REQUIRE(!algo::has_pending_help_requests());
+            REQUIRE(!algo::help_with_pending_request());
+        }
+        REQUIRE(call_count == 1);
+    }
+
+    SECTION("Listeners are told about new requests")
+    {
+        std::atomic<int> notification_count(0);
+        const int key = 0;
+        algo::add_help_listener(&key, [&]() { notification_count++; });
+        {
+            const algo::HelpRequest help_request(function, 1);
+        }
+        algo::remove_help_listener(&key);
+        {
+            const algo::HelpRequest help_request(function, 1);
+        }
+        REQUIRE(notification_count == 1);
+        REQUIRE(call_count == 0);
+    }
+}
@@ -16,7 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/pack/zlib.h"
+#include "algo/range.h"
 #include "io/memory_byte_stream.h"
+#include "io/segmented_byte_stream.h"
 #include "test_support/catch.h"
 #include "test_support/common.h"
 
@@ -43,6 +45,23 @@ TEST_CASE("ZLIB compression", "[algo][pack]")
         REQUIRE(input_stream.left() == 0);
     }
 
+    SECTION("Inflating ZLIB with known size")
+    {
+        tests::compare_binary(zlib_inflate(input, output.size()), output);
+        REQUIRE_THROWS(zlib_inflate(input, output.size() - 1));
+        REQUIRE_THROWS(zlib_inflate(input, output.size() + 1));
+        REQUIRE_THROWS(zlib_inflate(input.substr(0, 10), output.size()));
+    }
+
+    SECTION("Inflating ZLIB into existing buffer")
+    {
+        io::MemoryByteStream input_stream(input + "trailing"_b);
+        bstr target = "<"_b + bstr(output.size()) + ">"_b;
+        zlib_inflate(input_stream, target.get<u8>() + 1, output.size());
+        tests::compare_binary(target, "<"_b + output + ">"_b);
+        REQUIRE(input_stream.read_to_eof() == "trailing"_b);
+    }
+
     SECTION("Deflating ZLIB from bstr")
     {
         tests::compare_binary(zlib_inflate(zlib_deflate(output)), output);
@@ -55,3 +74,36 @@ TEST_CASE("ZLIB compression", "[algo][pack]")
         tests::compare_binary(inflated, output);
     }
 }
+
+TEST_CASE("ZLIB inflating large data with known size", "[algo][pack]")
+{
+    bstr output(100000);
+    u32 seed = 1;
+    for (const auto i : algo::range(output.size()))
+    {
+        seed = seed * 1103515245 + 12345;
+        output[i] = i & 1 ? seed >> 24 : i >> 8;
+    }
+    const auto input = zlib_deflate(output);
+
+    SECTION("From memory")
+    {
+        tests::compare_binary(zlib_inflate(input, output.size()), output);
+        REQUIRE_THROWS(zlib_inflate(input, output.size() - 1));
+    }
+
+    SECTION("From stream read in chunks")
+    {
+        // segmented streams expose no view, so the input is read piecewise
+        io::SegmentedByteStream input_stream;
+        input_stream.add_segment(
+            input.size(),
+            [&input]()
+            {
+                return std::make_unique<io::MemoryByteStream>(input);
+            });
+        tests::compare_binary(
+            zlib_inflate(input_stream, output.size()), output);
+        REQUIRE(input_stream.left() == 0);
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/str.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("JSON string escaping", "[algo]")
+{
+    SECTION("Plain text")
+    {
+        REQUIRE(algo::escape_json("abc") == "abc");
+        REQUIRE(algo::unescape_json("abc") == "abc");
+    }
+
+    SECTION("Quotes and backslashes")
+    {
+        REQUIRE(algo::escape_json("a\"b\\c") == "a\\\"b\\\\c");
+        REQUIRE(algo::unescape_json("a\\\"b\\\\c") == "a\"b\\c");
+    }
+
+    SECTION("Control characters")
+    {
+        const std::string input("a\nb\tc\x01\x1F", 7);
+        const auto escaped = algo::escape_json(input);
+        REQUIRE(escaped == "a\\u000ab\\u0009c\\u0001\\u001f");
+        REQUIRE(algo::unescape_json(escaped) == input);
+    }
+
+    SECTION("Short escape sequences")
+    {
+        REQUIRE(algo::unescape_json("\\b\\f\\n\\r\\t\\/")
+            == "\b\f\n\r\t/");
+    }
+}
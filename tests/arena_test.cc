@@ -0,0 +1,117 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "arena.h"
+#include <thread>
+#include "res/image.h"
+#include "test_support/catch.h"
+#include "types.h"
+
+using namespace au;
+
+TEST_CASE("Arena", "[core]")
+{
+    SECTION("Buffers outside of scope come from the heap")
+    {
+        const bstr x(100);
+        REQUIRE(!Arena::current());
+        REQUIRE(!Arena::owns(x.get<u8>()));
+    }
+
+    SECTION("Small buffers inside of scope come from the arena")
+    {
+        Arena arena;
+        {
+            const Arena::Scope scope(arena);
+            REQUIRE(Arena::current() == &arena);
+            const bstr x("test"_b);
+            const res::Image image(2, 2);
+            REQUIRE(Arena::owns(x.get<u8>()));
+            REQUIRE(Arena::owns(image.begin()));
+            REQUIRE(x == "test"_b);
+            REQUIRE(image.at(1, 1).a == 0);
+            REQUIRE(arena.block_count() == 1);
+        }
+        REQUIRE(!Arena::current());
+    }
+
+    SECTION("Large buffers inside of scope come from the heap")
+    {
+        Arena arena;
+        const Arena::Scope scope(arena);
+        const bstr x(Arena::max_allocation_size + 1);
+        REQUIRE(!Arena::owns(x.get<u8>()));
+        REQUIRE(arena.block_count() == 0);
+    }
+
+    SECTION("Scopes nest")
+    {
+        Arena outer_arena, inner_arena;
+        const Arena::Scope outer_scope(outer_arena);
+        {
+            const Arena::Scope inner_scope(inner_arena);
+            REQUIRE(Arena::current() == &inner_arena);
+        }
+        REQUIRE(Arena::current() == &outer_arena);
+    }
+
+    SECTION("Blocks are rewound once all their buffers are freed")
+    {
+        Arena arena;
+        const Arena::Scope scope(arena);
+        for (const auto i : algo::range(1000))
+        {
+            const bstr x(1000, i);
+            REQUIRE(x[999] == static_cast<u8>(i));
+        }
+        REQUIRE(arena.block_count() == 1);
+        REQUIRE(arena.used_size() <= 2048);
+    }
+
+    SECTION("Blocks in use are not rewound")
+    {
+        Arena arena;
+        const Arena::Scope scope(arena);
+        std::vector<bstr> buffers;
+        for (const auto i : algo::range(100))
+            buffers.push_back(bstr(Arena::max_allocation_size, i));
+        REQUIRE(arena.block_count() > 1);
+        arena.reset();
+        for (const auto i : algo::range(buffers.size()))
+        {
+            REQUIRE(buffers[i].size() == Arena::max_allocation_size);
+            REQUIRE(buffers[i][0] == static_cast<u8>(i));
+            REQUIRE(buffers[i][Arena::max_allocation_size - 1]
+                == static_cast<u8>(i));
+        }
+    }
+
+    SECTION("Buffers outlive their arena and can be freed on other threads")
+    {
+        std::unique_ptr<bstr> x;
+        {
+            Arena arena;
+            const Arena::Scope scope(arena);
+            x.reset(new bstr("test"_b));
+            REQUIRE(Arena::owns(x->get<u8>()));
+        }
+        REQUIRE(*x == "test"_b);
+        std::thread thread([&]() { x.reset(); });
+        thread.join();
+        REQUIRE(!x);
+    }
+}
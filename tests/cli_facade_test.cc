@@ -16,6 +16,14 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/cli_facade.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include "err.h"
+#include "io/file_byte_stream.h"
 #include "io/file_system.h"
 #include "test_support/catch.h"
 
@@ -60,4 +68,101 @@ TEST_CASE("CLI facade", "[core]")
         io::remove("./xp3-v2~.xp3/123.txt");
         io::remove("./xp3-v2~.xp3");
     }
+
+    SECTION("Unpacking archives with a memory budget")
+    {
+        const flow::CliFacade cli_facade(
+            logger,
+            {
+                "./tests/dec/kirikiri/files/xp3/xp3-v2.xp3",
+                "--dec=kirikiri/xp3",
+                "--plugin=noop",
+                "--max-memory=1",
+                "--threads=4"
+            });
+
+        REQUIRE(cli_facade.run() == 0);
+
+        REQUIRE(io::is_regular_file("./xp3-v2~.xp3/123.txt"));
+        REQUIRE(io::is_regular_file("./xp3-v2~.xp3/abc.xyz"));
+        io::remove("./xp3-v2~.xp3/abc.xyz");
+        io::remove("./xp3-v2~.xp3/123.txt");
+        io::remove("./xp3-v2~.xp3");
+    }
+
+    SECTION("Rejecting invalid memory budgets")
+    {
+        for (const auto value : {
+            "", "-1", "abc", "1.5M", "12KB", "K",
+            "99999999999999999999", "17179869184G"})
+        {
+            REQUIRE_THROWS_AS(
+                flow::CliFacade(
+                    logger, {"input", std::string("--max-memory=") + value}),
+                err::UsageError);
+        }
+        REQUIRE_NOTHROW(flow::CliFacade(logger, {"input", "--max-memory=16m"}));
+    }
+
+        SECTION("Writing a tar archive to the standard output")
+    {
+        Logger tar_logger;
+        const flow::CliFacade cli_facade(
+            tar_logger,
+            {
+                "./tests/dec/kirikiri/files/xp3/xp3-v2.xp3",
+                "./tests/cli_facade_test.cc",
+                "--dec=kirikiri/xp3",
+                "--plugin=noop",
+                "--tar=-"
+            });
+        REQUIRE(!tar_logger.colors_enabled());
+
+        // the logger colors its output when the standard input is
+        // a terminal, so provide one if possible
+        const auto stdin_copy = dup(STDIN_FILENO);
+        const auto terminal = posix_openpt(O_RDWR | O_NOCTTY);
+        if (terminal != -1 && !grantpt(terminal) && !unlockpt(terminal))
+        {
+            const auto tty = open(ptsname(terminal), O_RDWR | O_NOCTTY);
+            if (tty != -1)
+            {
+                dup2(tty, STDIN_FILENO);
+                close(tty);
+            }
+        }
+
+        // capture the standard output, which the archive is written to
+        const io::path stdout_path = "tests/trash_stdout.tar";
+        std::fflush(stdout);
+        const auto stdout_copy = dup(STDOUT_FILENO);
+        REQUIRE(std::freopen(stdout_path.str().c_str(), "wb", stdout));
+        std::stringstream errors;
+        const auto cerr_buf = std::cerr.rdbuf(errors.rdbuf());
+        const auto result = cli_facade.run();
+        std::cout.flush();
+        std::fflush(stdout);
+        std::cerr.rdbuf(cerr_buf);
+        dup2(stdout_copy, STDOUT_FILENO);
+        close(stdout_copy);
+        dup2(stdin_copy, STDIN_FILENO);
+        close(stdin_copy);
+        if (terminal != -1)
+            close(terminal);
+
+        // the second input is not an archive and must be reported
+        REQUIRE(result != 0);
+        REQUIRE(!errors.str().empty());
+
+        bstr data;
+        {
+            io::FileByteStream input_stream(stdout_path, io::FileMode::Read);
+            data = input_stream.read_to_eof();
+        }
+        io::remove(stdout_path);
+        REQUIRE(data.size() % 512 == 0);
+        REQUIRE(data.substr(257, 6) == "ustar "_b);
+        REQUIRE(data.substr(data.size() - 1024) == bstr(1024));
+        REQUIRE(data.find("\033"_b) == bstr::npos);
+    }
 }
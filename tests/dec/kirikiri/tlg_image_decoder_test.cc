@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/tlg_image_decoder.h"
+#include "flow/task_scheduler.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
 #include "test_support/file_support.h"
@@ -26,6 +27,38 @@ using namespace au::dec::kirikiri;
 
 static const std::string dir = "tests/dec/kirikiri/files/tlg/";
 
+namespace
+{
+    class DecodeTask final : public flow::ITask
+    {
+    public:
+        DecodeTask(
+            const std::string &input_path,
+            std::unique_ptr<res::Image> &output_image);
+        bool work() const override;
+
+    private:
+        const std::string input_path;
+        std::unique_ptr<res::Image> &output_image;
+    };
+}
+
+DecodeTask::DecodeTask(
+    const std::string &input_path, std::unique_ptr<res::Image> &output_image) :
+        input_path(input_path),
+        output_image(output_image)
+{
+}
+
+bool DecodeTask::work() const
+{
+    const auto decoder = TlgImageDecoder();
+    const auto input_file = tests::file_from_path(dir + input_path);
+    output_image = std::make_unique<res::Image>(
+        tests::decode(decoder, *input_file));
+    return true;
+}
+
 static void do_test(
     const std::string &input_path, const std::string &expected_path)
 {
@@ -48,6 +81,17 @@ TEST_CASE("KiriKiri TLG images", "[dec]")
         do_test("tlg6.tlg", "tlg6-out.png");
     }
 
+    SECTION("TLG6 decoded with help from idle workers")
+    {
+        std::unique_ptr<res::Image> actual_image;
+        flow::TaskScheduler task_scheduler;
+        task_scheduler.push_back(
+            std::make_shared<DecodeTask>("tlg6.tlg", actual_image));
+        REQUIRE(task_scheduler.run(4).success_count == 1);
+        const auto expected_file = tests::file_from_path(dir + "tlg6-out.png");
+        tests::compare_images(*actual_image, *expected_file);
+    }
+
     SECTION("TLG0")
     {
         do_test("bg08d.tlg", "bg08d-out.png");
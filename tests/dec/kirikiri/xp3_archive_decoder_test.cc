@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include "err.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
 #include "test_support/file_support.h"
@@ -75,4 +76,21 @@ TEST_CASE("KiriKiri XP3 archives", "[dec]")
     {
         do_test("xp3-time.xp3");
     }
+
+    SECTION("Segment sizes that don't match the entry")
+    {
+        Xp3ArchiveDecoder decoder;
+        decoder.plugin_manager.set("noop");
+        // size_orig of the first SEGM chunk
+        for (const u64 size_orig : {11ull, 0x100000000000ull})
+        {
+            const auto input_file = tests::file_from_path(
+                dir + "xp3-compressed-files.xp3");
+            io::File file(
+                input_file->path, input_file->stream.seek(0).read_to_eof());
+            file.stream.seek(164).write_le<u64>(size_orig);
+            REQUIRE_THROWS_AS(
+                tests::unpack(decoder, file), err::BadDataSizeError);
+        }
+    }
 }
@@ -0,0 +1,102 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/idecoder.h"
+#include "dec/registry.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::dec;
+
+static std::unique_ptr<Registry> create_registry()
+{
+    auto registry = Registry::create_mock();
+    for (const auto &name : {"magic", "offset", "ext", "plain", "both"})
+        registry->add_decoder(name, []() { return nullptr; });
+    registry->add_magic("magic", "ABCD"_b, 0);
+    registry->add_magic("magic", "AB\x00"_b, 0);
+    registry->add_magic("offset", "WXYZ"_b, 4);
+    registry->add_extension("ext", "dat");
+    registry->add_magic("both", "ABCDEF"_b, 0);
+    registry->add_extension("both", ".BIN");
+    return registry;
+}
+
+static std::set<std::string> get_candidates(
+    const Registry &registry, const io::path &path, const bstr &content)
+{
+    io::File input_file(path, content);
+    return registry.get_candidate_decoder_names(
+        {"magic", "offset", "ext", "plain", "both"}, input_file);
+}
+
+TEST_CASE("Decoder registry recognition hints", "[dec]")
+{
+    const auto registry = create_registry();
+
+    SECTION("Decoders without hints are always candidates")
+    {
+        REQUIRE(get_candidates(*registry, "test.txt", ""_b)
+            == std::set<std::string>({"plain"}));
+    }
+
+    SECTION("Magic at the beginning of the file")
+    {
+        REQUIRE(get_candidates(*registry, "test.txt", "ABCD"_b)
+            == std::set<std::string>({"magic", "plain"}));
+        REQUIRE(get_candidates(*registry, "test.txt", "AB\x00\x01"_b)
+            == std::set<std::string>({"magic", "plain"}));
+        REQUIRE(get_candidates(*registry, "test.txt", "ABCDEFGH"_b)
+            == std::set<std::string>({"magic", "both", "plain"}));
+        REQUIRE(get_candidates(*registry, "test.txt", "ABC"_b)
+            == std::set<std::string>({"plain"}));
+    }
+
+    SECTION("Magic at an offset")
+    {
+        REQUIRE(get_candidates(*registry, "test.txt", "????WXYZ"_b)
+            == std::set<std::string>({"offset", "plain"}));
+        REQUIRE(get_candidates(*registry, "test.txt", "WXYZ????"_b)
+            == std::set<std::string>({"plain"}));
+    }
+
+    SECTION("Extensions are case insensitive")
+    {
+        REQUIRE(get_candidates(*registry, "test.DAT", ""_b)
+            == std::set<std::string>({"ext", "plain"}));
+        REQUIRE(get_candidates(*registry, "test.bin", ""_b)
+            == std::set<std::string>({"both", "plain"}));
+    }
+
+    SECTION("Only the requested decoders are returned")
+    {
+        io::File input_file("test.dat", "ABCD"_b);
+        REQUIRE(registry->get_candidate_decoder_names({"ext"}, input_file)
+            == std::set<std::string>({"ext"}));
+    }
+}
+
+TEST_CASE("Decoder registry prototypes", "[dec]")
+{
+    const auto &registry = Registry::instance();
+    const auto prototype1 = registry.get_decoder_prototype("kirikiri/xp3");
+    const auto prototype2 = registry.get_decoder_prototype("kirikiri/xp3");
+    const auto decoder = registry.create_decoder("kirikiri/xp3");
+    REQUIRE(prototype1 != nullptr);
+    REQUIRE(prototype1 == prototype2);
+    REQUIRE(decoder != prototype1);
+}
@@ -0,0 +1,60 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "enc/image_encoder_registry.h"
+#include "err.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+
+using namespace au;
+
+TEST_CASE("Image encoder registry", "[enc]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto image = res::Image(1, 1);
+
+    SECTION("Every listed format can be created")
+    {
+        for (const auto &name : enc::get_image_encoder_names())
+        {
+            const auto encoder = enc::create_image_encoder(name);
+            REQUIRE(encoder);
+            REQUIRE(encoder->encode(dummy_logger, image, "test.dat")
+                ->stream.size() > 0);
+        }
+    }
+
+    SECTION("Formats determine the output extension")
+    {
+        const auto encode = [&](const std::string &name)
+        {
+            return enc::create_image_encoder(name)
+                ->encode(dummy_logger, image, "test.dat")->path.name();
+        };
+        REQUIRE(encode("png") == "test.png");
+        REQUIRE(encode("png-small") == "test.png");
+        REQUIRE(encode("bmp") == "test.bmp");
+        REQUIRE(encode("pam") == "test.pam");
+    }
+
+    SECTION("Unknown formats")
+    {
+        REQUIRE_THROWS_AS(
+            enc::create_image_encoder("gif"), err::UsageError);
+    }
+}
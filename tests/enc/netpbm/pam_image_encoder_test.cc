@@ -0,0 +1,48 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "enc/netpbm/pam_image_encoder.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+
+using namespace au;
+using namespace au::enc::netpbm;
+
+TEST_CASE("Netpbm PAM images encoding", "[enc]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto pam_encoder = PamImageEncoder();
+
+    res::Image input_image(2, 1);
+    input_image.at(0, 0).r = 1;
+    input_image.at(0, 0).g = 2;
+    input_image.at(0, 0).b = 3;
+    input_image.at(0, 0).a = 4;
+    input_image.at(1, 0).r = 5;
+    input_image.at(1, 0).g = 6;
+    input_image.at(1, 0).b = 7;
+    input_image.at(1, 0).a = 8;
+    const auto output_file
+        = pam_encoder.encode(dummy_logger, input_image, "test.dat");
+    REQUIRE(output_file->path.name() == "test.pam");
+    tests::compare_binary(
+        output_file->stream.seek(0).read_to_eof(),
+        "P7\nWIDTH 2\nHEIGHT 1\nDEPTH 4\nMAXVAL 255\n"
+        "TUPLTYPE RGB_ALPHA\nENDHDR\n"
+        "\x01\x02\x03\x04\x05\x06\x07\x08"_b);
+}
@@ -0,0 +1,87 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+#include "enc/png/png_image_encoder.h"
+#include "algo/range.h"
+#include "dec/png/png_image_decoder.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+#include "test_support/image_support.h"
+
+using namespace au;
+using namespace au::enc::png;
+
+static void test_round_trip(const res::Image &input_image)
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto decoder = dec::png::PngImageDecoder();
+    for (const auto profile : {
+        PngEncodeProfile::Store,
+        PngEncodeProfile::Fast,
+        PngEncodeProfile::Balanced,
+        PngEncodeProfile::Small})
+    {
+        const auto encoder = PngImageEncoder(profile);
+        const auto output_file
+            = encoder.encode(dummy_logger, input_image, "test.dat");
+        REQUIRE(output_file->path.name() == "test.png");
+        output_file->stream.seek(output_file->stream.size() - 12);
+        tests::compare_binary(
+            output_file->stream.read_to_eof(),
+            "\x00\x00\x00\x00IEND\xAE\x42\x60\x82"_b);
+        const auto output_image = decoder.decode(dummy_logger, *output_file);
+        tests::compare_images(input_image, output_image);
+    }
+}
+
+TEST_CASE("PNG images encoding", "[enc]")
+{
+    SECTION("Small image")
+    {
+        res::Image input_image(1, 1);
+        input_image.at(0, 0).r = 1;
+        input_image.at(0, 0).g = 2;
+        input_image.at(0, 0).b = 3;
+        input_image.at(0, 0).a = 4;
+        test_round_trip(input_image);
+    }
+
+    SECTION("Image compressed as a single band")
+    {
+        test_round_trip(tests::get_opaque_test_image());
+    }
+
+    SECTION("Image compressed in several bands")
+    {
+        test_round_trip(tests::get_transparent_test_image());
+    }
+
+    SECTION("Bands joining in the middle of a repeated pattern")
+    {
+        res::Image input_image(128, 4096);
+        for (const auto y : algo::range(input_image.height()))
+        for (const auto x : algo::range(input_image.width()))
+        {
+            auto &pixel = input_image.at(x, y);
+            pixel.r = x;
+            pixel.g = y;
+            pixel.b = (x * y) >> 4;
+            pixel.a = 0xFF - (y & 0x0F);
+        }
+        test_round_trip(input_image);
+    }
+}
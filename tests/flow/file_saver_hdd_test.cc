@@ -16,7 +16,11 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/file_saver_hdd.h"
+#include <thread>
+#include "algo/format.h"
+#include "algo/range.h"
 #include "io/file_system.h"
+#include "io/slice_byte_stream.h"
 #include "test_support/catch.h"
 
 using namespace au;
@@ -95,4 +99,124 @@ TEST_CASE("FileSaver", "[core]")
         const flow::FileSaverHdd file_saver(".", true);
         do_test_overwriting(file_saver, file_saver, true);
     }
+
+    SECTION("Slices of files on disk")
+    {
+        const io::path archive_path = "test.arc";
+        const io::path path = "test.out";
+        {
+            io::FileByteStream archive_stream(
+                archive_path, io::FileMode::Write);
+            archive_stream.write("headertestfooter"_b);
+        }
+        {
+            const flow::FileSaverHdd file_saver(".", true);
+            io::File archive_file(archive_path, io::FileMode::Read);
+            file_saver.save(std::make_shared<io::File>(
+                path,
+                std::make_unique<io::SliceByteStream>(
+                    archive_file.stream, 6, 4)));
+        }
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Read);
+            REQUIRE(file_stream.read_to_eof() == "test"_b);
+        }
+        io::remove(path);
+        io::remove(archive_path);
+    }
+
+    SECTION("Concurrent saves reserve unique names")
+    {
+        const flow::FileSaverHdd file_saver(".", true);
+        const auto thread_count = 8;
+        std::vector<io::path> paths;
+        paths.push_back("test.txt");
+        for (const auto i : algo::range(1, thread_count))
+            paths.push_back(algo::format("test(%d).txt", i));
+
+        try
+        {
+            std::vector<std::thread> threads;
+            for (const auto i : algo::range(thread_count))
+            {
+                threads.push_back(std::thread([&file_saver]()
+                {
+                    file_saver.save(
+                        std::make_shared<io::File>("test.txt", "test"_b));
+                }));
+            }
+            for (auto &thread : threads)
+                thread.join();
+
+            REQUIRE(file_saver.get_saved_file_count() == thread_count);
+            for (const auto &path : paths)
+            {
+                REQUIRE(io::exists(path));
+                io::FileByteStream file_stream(path, io::FileMode::Read);
+                REQUIRE(file_stream.read_to_eof() == "test"_b);
+            }
+            for (const auto &path : paths)
+                io::remove(path);
+        }
+        catch (...)
+        {
+            for (const auto &path : paths)
+                if (io::exists(path)) io::remove(path);
+            throw;
+        }
+    }
+
+    SECTION("Concurrent saves reserve unique names without overwriting")
+    {
+        const flow::FileSaverHdd file_saver(".", false);
+        const auto thread_count = 8;
+        const io::path existing_path = "test.txt";
+        std::vector<io::path> paths;
+        for (const auto i : algo::range(1, thread_count + 1))
+            paths.push_back(algo::format("test(%d).txt", i));
+
+        try
+        {
+            {
+                io::FileByteStream file_stream(
+                    existing_path, io::FileMode::Write);
+                file_stream.write("existing"_b);
+            }
+
+            std::vector<std::thread> threads;
+            for (const auto i : algo::range(thread_count))
+            {
+                threads.push_back(std::thread([&file_saver]()
+                {
+                    file_saver.save(
+                        std::make_shared<io::File>("test.txt", "test"_b));
+                }));
+            }
+            for (auto &thread : threads)
+                thread.join();
+
+            REQUIRE(file_saver.get_saved_file_count() == thread_count);
+            {
+                io::FileByteStream file_stream(
+                    existing_path, io::FileMode::Read);
+                REQUIRE(file_stream.read_to_eof() == "existing"_b);
+            }
+            for (const auto &path : paths)
+            {
+                REQUIRE(io::exists(path));
+                io::FileByteStream file_stream(path, io::FileMode::Read);
+                REQUIRE(file_stream.read_to_eof() == "test"_b);
+            }
+            io::remove(existing_path);
+            for (const auto &path : paths)
+                io::remove(path);
+        }
+        catch (...)
+        {
+            if (io::exists(existing_path)) io::remove(existing_path);
+            for (const auto &path : paths)
+                if (io::exists(path)) io::remove(path);
+            throw;
+        }
+    }
 }
@@ -0,0 +1,127 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_tar.h"
+#include "algo/range.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "io/memory_byte_stream.h"
+#include "io/segmented_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+namespace
+{
+    struct TarMember final
+    {
+        std::string name;
+        char type;
+        bstr data;
+    };
+}
+
+static std::vector<TarMember> read_tar(io::BaseByteStream &input_stream)
+{
+    std::vector<TarMember> members;
+    while (true)
+    {
+        const auto header = input_stream.read(512);
+        if (header == bstr(512))
+            break;
+        u32 checksum = 0;
+        for (const auto i : algo::range(512))
+            checksum += i >= 148 && i < 156 ? ' ' : header[i];
+        REQUIRE(std::stoul(header.substr(148, 7).str(true), nullptr, 8)
+            == checksum);
+        REQUIRE(header.substr(257, 6) == "ustar "_b);
+        TarMember member;
+        member.name = header.substr(0, 100).str(true);
+        member.type = header[156];
+        const auto size = std::stoull(
+            header.substr(124, 12).str(true), nullptr, 8);
+        member.data = input_stream.read(size);
+        input_stream.skip((512 - size % 512) % 512);
+        members.push_back(member);
+    }
+    REQUIRE(input_stream.read_to_eof() == bstr(512));
+    return members;
+}
+
+TEST_CASE("FileSaverTar", "[flow]")
+{
+    const io::path path = "tests/trash.tar";
+    const std::string long_name(150, 'x');
+    {
+        const flow::FileSaverTar file_saver(path);
+        REQUIRE(file_saver.save(
+            std::make_shared<io::File>("dir/test.txt", "test"_b))
+                == "dir/test.txt");
+        REQUIRE(file_saver.save(
+            std::make_shared<io::File>("dir/test.txt", "duplicate"_b))
+                == "dir/test(1).txt");
+        REQUIRE(file_saver.save(
+            std::make_shared<io::File>("dir\\test.txt", "backslash"_b))
+                == "dir/test(2).txt");
+        file_saver.save(std::make_shared<io::File>(long_name, ""_b));
+        file_saver.save(std::make_shared<io::File>(
+            "stream.dat",
+            std::make_unique<io::MemoryByteStream>(bstr(1000, 'a'))));
+        REQUIRE(file_saver.get_saved_file_count() == 5);
+
+        // the second segment turns out shorter than declared
+        auto broken_stream = std::make_unique<io::SegmentedByteStream>();
+        broken_stream->add_segment(600, []()
+        {
+            return std::make_unique<io::MemoryByteStream>(bstr(600, 'b'));
+        });
+        broken_stream->add_segment(600, []()
+        {
+            return std::make_unique<io::MemoryByteStream>("de"_b);
+        });
+        const auto broken_file = std::make_shared<io::File>(
+            "broken.dat", std::move(broken_stream));
+        REQUIRE_THROWS(file_saver.save(broken_file));
+        file_saver.save(std::make_shared<io::File>("after.txt", "after"_b));
+    }
+
+    {
+        io::FileByteStream input_stream(path, io::FileMode::Read);
+        REQUIRE(input_stream.size() % 512 == 0);
+        const auto members = read_tar(input_stream);
+        REQUIRE(members.size() == 8);
+        REQUIRE(members[0].name == "dir/test.txt");
+        REQUIRE(members[0].type == '0');
+        REQUIRE(members[0].data == "test"_b);
+        REQUIRE(members[1].name == "dir/test(1).txt");
+        REQUIRE(members[1].data == "duplicate"_b);
+        REQUIRE(members[2].name == "dir/test(2).txt");
+        REQUIRE(members[2].data == "backslash"_b);
+        REQUIRE(members[3].type == 'L');
+        REQUIRE(members[3].data == bstr(long_name + '\0'));
+        REQUIRE(members[4].type == '0');
+        REQUIRE(members[4].data.empty());
+        REQUIRE(members[5].name == "stream.dat");
+        REQUIRE(members[5].data == bstr(1000, 'a'));
+        REQUIRE(members[6].name == "broken.dat");
+        REQUIRE(members[6].data == bstr(1200));
+        REQUIRE(members[7].name == "after.txt");
+        REQUIRE(members[7].data == "after"_b);
+    }
+
+    io::remove(path);
+}
@@ -0,0 +1,124 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/memory_budget.h"
+#include <atomic>
+#include <thread>
+#include "io/slice_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+TEST_CASE("MemoryBudget", "[flow]")
+{
+    SECTION("Tracks bytes until the last copy is destroyed")
+    {
+        const MemoryBudget memory_budget(100);
+        auto file = memory_budget.track(
+            std::make_shared<io::File>("test", "12345"_b));
+        REQUIRE(memory_budget.get_used() == 5);
+        auto file_copy = file;
+        file.reset();
+        REQUIRE(memory_budget.get_used() == 5);
+        REQUIRE(file_copy->stream.seek(0).read_to_eof() == "12345"_b);
+        file_copy.reset();
+        REQUIRE(memory_budget.get_used() == 0);
+    }
+
+    SECTION("Slices are charged for the buffer they keep alive")
+    {
+        const MemoryBudget memory_budget(100);
+        std::shared_ptr<io::File> file1, file2;
+        {
+            io::File archive_file("test", "12345"_b);
+            file1 = memory_budget.track(std::make_shared<io::File>(
+                "test",
+                std::make_unique<io::SliceByteStream>(
+                    archive_file.stream, 1, 3)));
+            file2 = memory_budget.track(std::make_shared<io::File>(
+                "test",
+                std::make_unique<io::SliceByteStream>(
+                    archive_file.stream, 0, 2)));
+        }
+        REQUIRE(memory_budget.get_used() == 5);
+        REQUIRE(file1->stream.seek(0).read_to_eof() == "234"_b);
+        file1.reset();
+        REQUIRE(memory_budget.get_used() == 5);
+        REQUIRE(file2->stream.seek(0).read_to_eof() == "12"_b);
+        file2.reset();
+        REQUIRE(memory_budget.get_used() == 0);
+    }
+
+    SECTION("Files read on demand are not counted")
+    {
+        const MemoryBudget memory_budget(100);
+        io::File archive_file(
+            "tests/flow/memory_budget_test.cc", io::FileMode::Read);
+        const auto file = memory_budget.track(std::make_shared<io::File>(
+            "test",
+            std::make_unique<io::SliceByteStream>(archive_file.stream, 1, 3)));
+        REQUIRE(memory_budget.get_used() == 0);
+        REQUIRE(file->stream.seek(0).read_to_eof() == "/ C"_b);
+    }
+
+    SECTION("Unlimited budget doesn't track anything")
+    {
+        const MemoryBudget memory_budget(0);
+        const auto file = memory_budget.track(
+            std::make_shared<io::File>("test", "12345"_b));
+        REQUIRE(memory_budget.get_used() == 0);
+        memory_budget.wait(2);
+    }
+
+    SECTION("Files outliving the budget are released safely")
+    {
+        std::shared_ptr<io::File> file;
+        {
+            const MemoryBudget memory_budget(1);
+            file = memory_budget.track(
+                std::make_shared<io::File>("test", "12345"_b));
+        }
+        file.reset();
+    }
+
+    SECTION("The last worker never waits")
+    {
+        const MemoryBudget memory_budget(1);
+        const auto file = memory_budget.track(
+            std::make_shared<io::File>("test", "12345"_b));
+        memory_budget.wait(1);
+    }
+
+    SECTION("Waiting workers resume once memory is freed")
+    {
+        const MemoryBudget memory_budget(1);
+        auto file = memory_budget.track(
+            std::make_shared<io::File>("test", "12345"_b));
+        std::atomic<bool> resumed(false);
+        std::thread worker([&]()
+        {
+            memory_budget.wait(2);
+            resumed = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(!resumed);
+        file.reset();
+        worker.join();
+        REQUIRE(resumed);
+    }
+}
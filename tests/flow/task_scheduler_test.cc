@@ -0,0 +1,160 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/task_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include "algo/idle_helpers.h"
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    class TestTask final : public ITask
+    {
+    public:
+        TestTask(std::function<bool()> callback);
+        bool work() const override;
+
+    private:
+        std::function<bool()> callback;
+    };
+}
+
+TestTask::TestTask(std::function<bool()> callback) : callback(callback)
+{
+}
+
+bool TestTask::work() const
+{
+    return callback();
+}
+
+static void push_tree(
+    TaskScheduler &task_scheduler,
+    std::atomic<int> &counter,
+    const size_t depth)
+{
+    task_scheduler.push_front(std::make_shared<TestTask>([&, depth]()
+    {
+        ++counter;
+        if (depth > 0)
+        {
+            push_tree(task_scheduler, counter, depth - 1);
+            push_tree(task_scheduler, counter, depth - 1);
+        }
+        return true;
+    }));
+}
+
+TEST_CASE("TaskScheduler", "[flow]")
+{
+    SECTION("Runs tasks in LIFO order on a single thread")
+    {
+        TaskScheduler task_scheduler;
+        std::vector<int> order;
+        for (const auto i : {1, 2, 3})
+        {
+            task_scheduler.push_back(std::make_shared<TestTask>([&, i]()
+            {
+                task_scheduler.push_front(std::make_shared<TestTask>([&, i]()
+                {
+                    order.push_back(i * 10);
+                    return true;
+                }));
+                order.push_back(i);
+                return true;
+            }));
+        }
+        const auto result = task_scheduler.run(1);
+        REQUIRE(result.success_count == 6);
+        REQUIRE(result.error_count == 0);
+        REQUIRE(order == std::vector<int>({1, 10, 2, 20, 3, 30}));
+    }
+
+    SECTION("Counts failed tasks")
+    {
+        TaskScheduler task_scheduler;
+        task_scheduler.push_back(
+            std::make_shared<TestTask>([]() { return true; }));
+        task_scheduler.push_back(
+            std::make_shared<TestTask>([]() { return false; }));
+        const auto result = task_scheduler.run(2);
+        REQUIRE(result.success_count == 1);
+        REQUIRE(result.error_count == 1);
+    }
+
+    SECTION("Doesn't stop while tasks keep pushing children")
+    {
+        for (const auto thread_count : {1, 2, 4, 8})
+        {
+            TaskScheduler task_scheduler;
+            std::atomic<int> counter(0);
+            push_tree(task_scheduler, counter, 10);
+            const auto result = task_scheduler.run(thread_count);
+            REQUIRE(counter == 2047);
+            REQUIRE(result.success_count == 2047);
+            REQUIRE(result.error_count == 0);
+        }
+    }
+
+    SECTION("Returns immediately when there's nothing to do")
+    {
+        TaskScheduler task_scheduler;
+        const auto result = task_scheduler.run(4);
+        REQUIRE(result.success_count == 0);
+        REQUIRE(result.error_count == 0);
+    }
+
+    SECTION("Lends idle workers to tasks asking for help")
+    {
+        for (const auto thread_count : {1, 2})
+        {
+            TaskScheduler task_scheduler;
+            std::atomic<bool> helped(false);
+            task_scheduler.push_back(std::make_shared<TestTask>([&]()
+            {
+                const auto task_thread = std::this_thread::get_id();
+                const algo::HelpRequest help_request(
+                    [&]()
+                    {
+                        if (std::this_thread::get_id() != task_thread)
+                            helped = true;
+                    },
+                    1);
+                // with a single thread there's nobody to wait for
+                const auto attempts = thread_count > 1 ? 500 : 10;
+                for (const auto i : algo::range(attempts))
+                {
+                    if (helped)
+                        break;
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(10));
+                }
+                return true;
+            }));
+            const auto result = task_scheduler.run(thread_count);
+            REQUIRE(helped == (thread_count > 1));
+            REQUIRE(result.success_count == 1);
+        }
+    }
+}
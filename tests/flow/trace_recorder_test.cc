@@ -0,0 +1,92 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/trace_recorder.h"
+#include <thread>
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+static std::string read_trace(const TraceRecorder &recorder)
+{
+    const io::path path = "trace-test.json";
+    recorder.save(path);
+    std::string content;
+    {
+        io::FileByteStream file_stream(path, io::FileMode::Read);
+        content = file_stream.read_to_eof().str();
+    }
+    io::remove(path);
+    return content;
+}
+
+TEST_CASE("TraceRecorder", "[flow]")
+{
+    SECTION("Disabled recorder ignores events")
+    {
+        const TraceRecorder recorder(false);
+        {
+            TraceSpan span(recorder, "decode", "vendor/name", "file.dat");
+        }
+        REQUIRE(read_trace(recorder).find("decode") == std::string::npos);
+    }
+
+    SECTION("Spans are saved as complete events")
+    {
+        const TraceRecorder recorder(true);
+        {
+            TraceSpan span(recorder, "recognition", "", "file.dat");
+            span.set_decoder_name("vendor/name");
+        }
+        const auto trace = read_trace(recorder);
+        REQUIRE(trace.find("\"name\": \"recognition\"") != std::string::npos);
+        REQUIRE(trace.find("\"ph\": \"X\"") != std::string::npos);
+        REQUIRE(trace.find("\"decoder\": \"vendor/name\"")
+            != std::string::npos);
+        REQUIRE(trace.find("\"file\": \"file.dat\"") != std::string::npos);
+    }
+
+    SECTION("Special characters are escaped")
+    {
+        const TraceRecorder recorder(true);
+        {
+            TraceSpan span(recorder, "save", "", "dir\\\"quoted\"");
+        }
+        const auto trace = read_trace(recorder);
+        REQUIRE(trace.find("\"file\": \"dir\\\\\\\"quoted\\\"\"")
+            != std::string::npos);
+    }
+
+    SECTION("Threads get distinct identifiers")
+    {
+        const TraceRecorder recorder(true);
+        {
+            TraceSpan span(recorder, "decode", "", "main");
+        }
+        std::thread worker([&]()
+        {
+            TraceSpan span(recorder, "decode", "", "worker");
+        });
+        worker.join();
+        const auto trace = read_trace(recorder);
+        REQUIRE(trace.find("\"tid\": 1") != std::string::npos);
+        REQUIRE(trace.find("\"tid\": 2") != std::string::npos);
+    }
+}
@@ -183,11 +183,11 @@ TEST_CASE("Recursive unpacking with nested archives", "[flow]")
     const auto saved_files = tests::flow_unpack(*registry, true, dummy_file);
     REQUIRE(saved_files.size() == 2);
     tests::compare_paths(
-        saved_files[0]->path, "outer.arc/inner.arc/nested/text.txt");
+        saved_files[0]->path, "outer.arc/inner.arc/nested/image.png");
     tests::compare_paths(
-        saved_files[1]->path, "outer.arc/inner.arc/nested/image.png");
-    REQUIRE(saved_files[0]->stream.read_to_eof() == "text"_b);
-    REQUIRE(saved_files[1]->stream.read_to_eof() == "decoded_image"_b);
+        saved_files[1]->path, "outer.arc/inner.arc/nested/text.txt");
+    REQUIRE(saved_files[0]->stream.read_to_eof() == "decoded_image"_b);
+    REQUIRE(saved_files[1]->stream.read_to_eof() == "text"_b);
 }
 
 TEST_CASE(
@@ -163,9 +163,9 @@ TEST_CASE("Recursive unpacking with virtual file system lookups", "[flow]")
     const auto saved_files = tests::flow_unpack(*registry, true, dummy_file);
     REQUIRE(saved_files.size() == 2);
     tests::compare_paths(
-        saved_files[0]->path, "outer.arc/inner.arc/nested/aside.txt");
+        saved_files[0]->path, "outer.arc/inner.arc/nested/image.png");
     tests::compare_paths(
-        saved_files[1]->path, "outer.arc/inner.arc/nested/image.png");
-    REQUIRE(saved_files[0]->stream.read_to_eof().str() == "aside");
-    REQUIRE(saved_files[1]->stream.read_to_eof().str() == "aside_used");
+        saved_files[1]->path, "outer.arc/inner.arc/nested/aside.txt");
+    REQUIRE(saved_files[0]->stream.read_to_eof().str() == "aside_used");
+    REQUIRE(saved_files[1]->stream.read_to_eof().str() == "aside");
 }
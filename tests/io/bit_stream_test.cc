@@ -428,6 +428,56 @@ template<class T> static void test_retracting()
     }
 }
 
+template<class T> static void test_peeking(const TestType type)
+{
+    SECTION("Peeking and consuming")
+    {
+        SECTION("Peeking doesn't consume bits")
+        {
+            T reader("\x8F"_b); // 10001111
+            REQUIRE((reader.peek(4) == (type == TestType::Msb ? 8 : 15)));
+            REQUIRE((reader.peek(4) == (type == TestType::Msb ? 8 : 15)));
+            REQUIRE((reader.pos() == 0));
+            reader.consume(4);
+            REQUIRE((reader.pos() == 4));
+            REQUIRE((reader.read(4) == (type == TestType::Msb ? 15 : 8)));
+        }
+
+        SECTION("Peeking beyond EOF pads with zeros")
+        {
+            T reader("\xFF"_b);
+            reader.consume(4);
+            REQUIRE((reader.peek(8) == (type == TestType::Msb ? 0xF0 : 0x0F)));
+            REQUIRE_THROWS(reader.consume(5));
+            reader.consume(4);
+            REQUIRE((reader.left() == 0));
+        }
+    }
+}
+
+template<class T> static void test_word_refill()
+{
+    SECTION("Bulk refill matches stream refill")
+    {
+        bstr input;
+        for (const auto i : algo::range(67))
+            input += static_cast<u8>(i * 37 + 11);
+        io::MemoryByteStream input_stream(input);
+        T fast_reader(input);
+        T slow_reader(input_stream);
+        size_t bits = 1;
+        while (fast_reader.left() >= bits)
+        {
+            REQUIRE((fast_reader.peek(bits) == slow_reader.peek(bits)));
+            REQUIRE((fast_reader.read(bits) == slow_reader.read(bits)));
+            bits = bits % 32 + 1;
+        }
+        REQUIRE((fast_reader.pos() == slow_reader.pos()));
+        REQUIRE_THROWS(fast_reader.read(bits));
+        REQUIRE_THROWS(slow_reader.read(bits));
+    }
+}
+
 TEST_CASE("BaseBitStream", "[io]")
 {
     test_reading_missing_bits<io::MsbBitStream>();
@@ -443,6 +493,8 @@ TEST_CASE("LsbBitStream", "[io]")
     test_reading_single_bits<io::LsbBitStream>(TestType::Lsb);
     test_reading_multiple_bits<io::LsbBitStream>(TestType::Lsb);
     test_reading_multiple_bytes<io::LsbBitStream>(TestType::Lsb);
+    test_peeking<io::LsbBitStream>(TestType::Lsb);
+    test_word_refill<io::LsbBitStream>();
 }
 
 TEST_CASE("MsbBitStream", "[io]")
@@ -451,4 +503,6 @@ TEST_CASE("MsbBitStream", "[io]")
     test_reading_multiple_bits<io::MsbBitStream>(TestType::Msb);
     test_reading_multiple_bytes<io::MsbBitStream>(TestType::Msb);
     test_writing<io::MsbBitStream>(TestType::Msb);
+    test_peeking<io::MsbBitStream>(TestType::Msb);
+    test_word_refill<io::MsbBitStream>();
 }
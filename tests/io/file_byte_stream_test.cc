@@ -51,6 +51,34 @@ TEST_CASE("FileByteStream", "[io][stream]")
         io::remove("tests/trash.out");
     }
 
+    SECTION("Clones keep their own position")
+    {
+        {
+            io::FileByteStream stream("tests/trash.out", io::FileMode::Write);
+            stream.write("0123456789"_b);
+            REQUIRE(stream.size() == 10);
+            stream.seek(2);
+            const auto clone = stream.clone();
+            clone->write("ab"_b);
+            REQUIRE(stream.pos() == 2);
+            REQUIRE(clone->pos() == 4);
+            REQUIRE(stream.read(3) == "ab4"_b);
+        }
+
+        {
+            io::FileByteStream stream("tests/trash.out", io::FileMode::Read);
+            stream.seek(8);
+            auto clone = stream.clone();
+            REQUIRE(clone->pos() == 8);
+            REQUIRE(clone->seek(0).read(4) == "01ab"_b);
+            REQUIRE(stream.read_to_eof() == "89"_b);
+            REQUIRE(clone->size() == 10);
+            REQUIRE_THROWS(clone->seek(11));
+        }
+
+        io::remove("tests/trash.out");
+    }
+
     SECTION("Full test suite")
     {
         tests::stream_test(
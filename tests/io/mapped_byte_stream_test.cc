@@ -0,0 +1,157 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/mapped_byte_stream.h"
+#include "err.h"
+#include "io/file.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static const io::path path = "tests/trash.out";
+
+static void create_file(const bstr &content)
+{
+    io::FileByteStream stream(path, io::FileMode::Write);
+    stream.write(content);
+}
+
+TEST_CASE("MappedByteStream", "[io][stream]")
+{
+    SECTION("Reading")
+    {
+        create_file("\x01\x02\x03\x04rest"_b);
+        {
+            io::MappedByteStream stream(path);
+            REQUIRE(stream.size() == 8);
+            REQUIRE(stream.read_le<u32>() == 0x04030201);
+            REQUIRE(stream.pos() == 4);
+            REQUIRE(stream.read_to_eof() == "rest"_b);
+            REQUIRE_THROWS(stream.read<u8>());
+            REQUIRE(stream.seek(1).read(2) == "\x02\x03"_b);
+            REQUIRE(stream.read_at(4, 2) == "re"_b);
+            REQUIRE(stream.pos() == 3);
+            REQUIRE_THROWS(stream.read_at(7, 2));
+            REQUIRE_THROWS(stream.seek(9));
+        }
+        io::remove(path);
+    }
+
+    SECTION("Zero-copy views")
+    {
+        create_file("abcdef"_b);
+        {
+            io::MappedByteStream stream(path);
+            stream.seek(2);
+            const auto view = stream.read_view(3);
+            REQUIRE(bstr(view, 3) == "cde"_b);
+            REQUIRE(stream.pos() == 5);
+            REQUIRE_THROWS(stream.read_view(2));
+            REQUIRE(stream.pos() == 5);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Prefetching")
+    {
+        create_file("abcdef"_b);
+        {
+            io::MappedByteStream stream(path);
+            REQUIRE_NOTHROW(stream.prefetch(2, 100));
+            REQUIRE_NOTHROW(stream.prefetch(100, 1));
+            REQUIRE(stream.read_to_eof() == "abcdef"_b);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Clones share the mapping, but not the position")
+    {
+        create_file("abcdef"_b);
+        {
+            std::unique_ptr<io::BaseByteStream> clone;
+            {
+                io::MappedByteStream stream(path);
+                stream.seek(2);
+                clone = stream.clone();
+                stream.seek(4);
+            }
+            REQUIRE(clone->pos() == 2);
+            REQUIRE(clone->read_to_eof() == "cdef"_b);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Empty files")
+    {
+        create_file(""_b);
+        {
+            io::MappedByteStream stream(path);
+            REQUIRE(stream.size() == 0);
+            REQUIRE(stream.read_to_eof() == ""_b);
+            REQUIRE_THROWS(stream.read<u8>());
+        }
+        io::remove(path);
+    }
+
+    SECTION("Writing is not supported")
+    {
+        create_file("abc"_b);
+        {
+            io::MappedByteStream stream(path);
+            REQUIRE_THROWS_AS(
+                stream.write("x"_b), err::NotSupportedError);
+            REQUIRE_NOTHROW(stream.resize(3));
+            REQUIRE_THROWS_AS(stream.resize(2), err::NotSupportedError);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Missing files")
+    {
+        REQUIRE_THROWS_AS(
+            io::MappedByteStream("tests/missing.out"),
+            err::FileNotFoundError);
+    }
+
+    SECTION("Files opened for reading are mapped")
+    {
+        create_file("abc"_b);
+        {
+            io::File file(path, io::FileMode::Read);
+            REQUIRE(dynamic_cast<io::MappedByteStream*>(&file.stream));
+            REQUIRE(file.stream.read_to_eof() == "abc"_b);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Files opened for reading are not mapped when mapping is off")
+    {
+        create_file("abc"_b);
+        io::set_file_mapping_enabled(false);
+        {
+            io::File file(path, io::FileMode::Read);
+            REQUIRE(!dynamic_cast<io::MappedByteStream*>(&file.stream));
+            // truncating a mapped file would make reading it fault instead
+            create_file(""_b);
+            REQUIRE_THROWS_AS(file.stream.read(3), err::EofError);
+        }
+        io::set_file_mapping_enabled(true);
+        io::remove(path);
+    }
+}
@@ -0,0 +1,128 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/segmented_byte_stream.h"
+#include <thread>
+#include "algo/range.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("SegmentedByteStream", "[io][stream]")
+{
+    int open_count = 0;
+    io::SegmentedByteStream stream;
+    for (const auto &segment : {"012"_b, ""_b, "3456"_b, "789"_b})
+    {
+        stream.add_segment(
+            segment.size(),
+            [segment, &open_count]()
+            {
+                open_count++;
+                return std::make_unique<io::MemoryByteStream>(segment);
+            });
+    }
+
+    SECTION("Segments are opened only when reached")
+    {
+        REQUIRE(stream.size() == 10);
+        REQUIRE(open_count == 0);
+        REQUIRE(stream.read(2) == "01"_b);
+        REQUIRE(open_count == 1);
+        REQUIRE(stream.read(1) == "2"_b);
+        REQUIRE(open_count == 1);
+    }
+
+    SECTION("Reading across segments")
+    {
+        REQUIRE(stream.read(5) == "01234"_b);
+        REQUIRE(stream.read_to_eof() == "56789"_b);
+        REQUIRE_THROWS(stream.read<u8>());
+    }
+
+    SECTION("Seeking and positional reads")
+    {
+        REQUIRE(stream.seek(6).read(3) == "678"_b);
+        REQUIRE(stream.read_at(2, 3) == "234"_b);
+        REQUIRE(stream.pos() == 9);
+        REQUIRE_THROWS(stream.seek(11));
+        REQUIRE_THROWS(stream.read_at(8, 3));
+    }
+
+    SECTION("Writing is not supported")
+    {
+        REQUIRE_THROWS(stream.write("x"_b));
+    }
+
+    SECTION("Clones share segments but not position")
+    {
+        stream.seek(4);
+        const auto clone = stream.clone();
+        REQUIRE(clone->read_to_eof() == "456789"_b);
+        REQUIRE(stream.read(2) == "45"_b);
+    }
+
+    SECTION("Segments of wrong size are rejected")
+    {
+        io::SegmentedByteStream bad_stream;
+        bad_stream.add_segment(
+            3,
+            []()
+            {
+                return std::make_unique<io::MemoryByteStream>("ab"_b);
+            });
+        REQUIRE_THROWS(bad_stream.read(1));
+    }
+}
+
+TEST_CASE("SegmentedByteStream read concurrently", "[io][stream]")
+{
+    io::SegmentedByteStream stream;
+    for (const auto i : algo::range(4))
+    {
+        stream.add_segment(
+            4096,
+            [i]()
+            {
+                return std::make_unique<io::MemoryByteStream>(
+                    bstr(4096, 'a' + i));
+            });
+    }
+
+    // each thread keeps switching segments, so they fight over the one
+    // that is kept open
+    std::vector<std::thread> threads;
+    bool results[2] = {true, true};
+    for (const auto t : algo::range(2))
+    {
+        threads.push_back(std::thread([&stream, &results, t]()
+        {
+            for (const auto i : algo::range(2000))
+            {
+                const auto segment = (i + t) % 4;
+                const auto data = stream.read_at(segment * 4096 + 100, 16);
+                if (data != bstr(16, 'a' + segment))
+                    results[t] = false;
+            }
+        }));
+    }
+    for (auto &thread : threads)
+        thread.join();
+    REQUIRE(results[0]);
+    REQUIRE(results[1]);
+}
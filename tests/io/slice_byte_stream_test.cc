@@ -0,0 +1,194 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/slice_byte_stream.h"
+#include <thread>
+#include "algo/range.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("SliceByteStream", "[io][stream]")
+{
+    io::MemoryByteStream parent_stream("0123456789"_b);
+    parent_stream.seek(7);
+
+    SECTION("Reading")
+    {
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        REQUIRE(stream.size() == 5);
+        REQUIRE(stream.pos() == 0);
+        REQUIRE(stream.read(3) == "234"_b);
+        REQUIRE(stream.pos() == 3);
+        REQUIRE(stream.read_to_eof() == "56"_b);
+        REQUIRE_THROWS(stream.read<u8>());
+        REQUIRE(parent_stream.pos() == 7);
+    }
+
+    SECTION("Reading until the end of the parent")
+    {
+        io::SliceByteStream stream(parent_stream, 6);
+        REQUIRE(stream.read_to_eof() == "6789"_b);
+    }
+
+    SECTION("Seeking is confined to the slice")
+    {
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        REQUIRE(stream.seek(5).pos() == 5);
+        REQUIRE_THROWS(stream.seek(6));
+        REQUIRE(stream.seek(1).read(2) == "34"_b);
+    }
+
+    SECTION("Positional reads")
+    {
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        stream.seek(1);
+        REQUIRE(stream.read_at(3, 2) == "56"_b);
+        REQUIRE(stream.pos() == 1);
+        REQUIRE_THROWS(stream.read_at(4, 2));
+    }
+
+    SECTION("Slices exceeding the parent")
+    {
+        REQUIRE_THROWS(io::SliceByteStream(parent_stream, 2, 9));
+    }
+
+    SECTION("Clones")
+    {
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        stream.seek(2);
+        const auto clone = stream.clone();
+        stream.seek(0);
+        REQUIRE(clone->pos() == 2);
+        REQUIRE(clone->read_to_eof() == "456"_b);
+        REQUIRE(stream.read(2) == "23"_b);
+    }
+
+    SECTION("Nested slices")
+    {
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        stream.seek(4);
+        io::SliceByteStream nested_stream(stream, 1, 3);
+        REQUIRE(nested_stream.read_to_eof() == "345"_b);
+        REQUIRE(stream.pos() == 4);
+        REQUIRE_THROWS(io::SliceByteStream(stream, 1, 5));
+    }
+
+    SECTION("Slices outlive their parent")
+    {
+        std::unique_ptr<io::BaseByteStream> stream;
+        {
+            io::MemoryByteStream temporary_stream("abc"_b);
+            stream = std::make_unique<io::SliceByteStream>(
+                temporary_stream, 1);
+        }
+        REQUIRE(stream->read_to_eof() == "bc"_b);
+    }
+
+    SECTION("Reporting file ranges")
+    {
+        io::FileRange range;
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        REQUIRE(!stream.get_file_range(range));
+
+        const io::path path = "tests/trash.out";
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Write);
+            file_stream.write("0123456789"_b);
+            REQUIRE(!file_stream.get_file_range(range));
+        }
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Read);
+            io::SliceByteStream file_slice(file_stream, 2, 5);
+            io::SliceByteStream nested_slice(file_slice, 1, 3);
+            REQUIRE(nested_slice.get_file_range(range));
+            REQUIRE(range.path == path);
+            REQUIRE(range.offset == 3);
+            REQUIRE(range.size == 3);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Prefetching")
+    {
+        const io::path path = "tests/trash.out";
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Write);
+            file_stream.write("0123456789"_b);
+        }
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Read);
+            io::SliceByteStream stream(file_stream, 2, 5);
+            REQUIRE_NOTHROW(stream.prefetch(1, 100));
+            REQUIRE_NOTHROW(stream.prefetch(100, 1));
+            REQUIRE(stream.read_to_eof() == "23456"_b);
+        }
+        io::remove(path);
+    }
+
+    SECTION("Views")
+    {
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        REQUIRE(stream.get_view(1, 3));
+        REQUIRE(bstr(stream.get_view(1, 3), 3) == "345"_b);
+        REQUIRE(stream.get_view(5, 0));
+        REQUIRE(!stream.get_view(3, 3));
+        REQUIRE(!stream.get_view(6, 0));
+        REQUIRE(stream.pos() == 0);
+    }
+
+    SECTION("Clones of file slices can be read concurrently")
+    {
+        const io::path path = "tests/trash.out";
+        bstr content;
+        for (const auto i : algo::range(4096))
+            content += static_cast<u8>(i * 7);
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Write);
+            file_stream.write(content);
+        }
+        {
+            io::FileByteStream file_stream(path, io::FileMode::Read);
+            const io::SliceByteStream stream(file_stream, 1024, 2048);
+            std::vector<int> results(8);
+            std::vector<std::thread> threads;
+            for (const auto i : algo::range(results.size()))
+            {
+                threads.push_back(std::thread([&, i]()
+                {
+                    auto clone = stream.clone();
+                    results[i] = 1;
+                    for (const auto j : algo::range(0, 2048, 64 + i))
+                    {
+                        clone->seek(j);
+                        const auto size = std::min<int>(64 + i, 2048 - j);
+                        if (clone->read(size) != content.substr(1024 + j, size))
+                            results[i] = 0;
+                    }
+                }));
+            }
+            for (auto &thread : threads)
+                thread.join();
+            for (const auto result : results)
+                REQUIRE(result);
+        }
+        io::remove(path);
+    }
+}
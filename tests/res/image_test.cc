@@ -17,6 +17,9 @@
 
 #include "res/image.h"
 #include "algo/range.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "io/memory_byte_stream.h"
 #include "test_support/catch.h"
 
 using namespace au;
@@ -269,3 +272,165 @@ TEST_CASE("Image offsetting", "[res]")
         }
     }
 }
+
+TEST_CASE("Image reading from streams", "[res]")
+{
+    const auto input = "xx\x01\x02\x03\x04\x05\x06yy"_b;
+
+    const auto test = [](io::BaseByteStream &input_stream)
+    {
+        input_stream.seek(2);
+        const res::Image image(2, 1, input_stream, res::PixelFormat::RGB888);
+        const res::Pixel expected_pixel1 = {3, 2, 1, 0xFF};
+        const res::Pixel expected_pixel2 = {6, 5, 4, 0xFF};
+        REQUIRE(input_stream.pos() == 8);
+        REQUIRE(image.at(0, 0) == expected_pixel1);
+        REQUIRE(image.at(1, 0) == expected_pixel2);
+        input_stream.seek(7);
+        REQUIRE_THROWS(
+            res::Image(2, 1, input_stream, res::PixelFormat::RGB888));
+    };
+
+    SECTION("Streams held in memory")
+    {
+        io::MemoryByteStream input_stream(input);
+        REQUIRE(input_stream.get_view(2, 6));
+        test(input_stream);
+    }
+
+    SECTION("Other streams")
+    {
+        const io::path path = "tests/trash.out";
+        {
+            io::FileByteStream output_stream(path, io::FileMode::Write);
+            output_stream.write(input);
+        }
+        {
+            io::FileByteStream input_stream(path, io::FileMode::Read);
+            REQUIRE(!input_stream.get_view(2, 6));
+            test(input_stream);
+        }
+        io::remove(path);
+    }
+}
+
+TEST_CASE("Image pixel operations", "[res]")
+{
+    // odd widths exercise both the vectorized loops and the leftovers
+    const auto width = 7;
+    const auto height = 3;
+
+    const auto make_pixel = [](const int x, const int y, const u8 a)
+    {
+        const res::Pixel pixel
+            = {static_cast<u8>(x * 40), static_cast<u8>(y * 90), 200, a};
+        return pixel;
+    };
+
+    res::Image image(width, height);
+    for (const auto y : algo::range(height))
+    for (const auto x : algo::range(width))
+        image.at(x, y) = make_pixel(x, y, x * 30);
+    const auto original_image = image;
+
+    SECTION("Inverting")
+    {
+        image.invert();
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+        {
+            const auto &pixel = image.at(x, y);
+            const auto &original_pixel = original_image.at(x, y);
+            REQUIRE(pixel.b == (original_pixel.b ^ 0xFF));
+            REQUIRE(pixel.g == (original_pixel.g ^ 0xFF));
+            REQUIRE(pixel.r == (original_pixel.r ^ 0xFF));
+            REQUIRE(pixel.a == original_pixel.a);
+        }
+    }
+
+    SECTION("Flipping")
+    {
+        image.flip_vertically();
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+            REQUIRE(image.at(x, y) == original_image.at(x, height - 1 - y));
+        image.flip_vertically();
+        image.flip_horizontally();
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+            REQUIRE(image.at(x, y) == original_image.at(width - 1 - x, y));
+    }
+
+    SECTION("Masking")
+    {
+        res::Image mask(width, height);
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+            mask.at(x, y).r = x + y * 10;
+        image.apply_mask(mask);
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+        {
+            auto expected_pixel = original_image.at(x, y);
+            expected_pixel.a = x + y * 10;
+            REQUIRE(image.at(x, y) == expected_pixel);
+        }
+    }
+
+    SECTION("Applying palette")
+    {
+        res::Palette palette(3);
+        for (const auto i : algo::range(3))
+            palette[i] = make_pixel(i, i, 0xFF);
+        res::Image indexed_image(width, height);
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+            indexed_image.at(x, y).r = (x + y) % 5;
+        indexed_image.apply_palette(palette);
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+        {
+            const auto index = (x + y) % 5;
+            if (index < 3)
+                REQUIRE(indexed_image.at(x, y) == palette[index]);
+            else
+                REQUIRE(indexed_image.at(x, y).a == 0);
+        }
+    }
+
+    SECTION("Overlaying non-transparent pixels")
+    {
+        res::Image base(width, height);
+        for (auto &pixel : base)
+            pixel = make_pixel(1, 1, 0xFF);
+        base.overlay(image, res::Image::OverlayKind::OverwriteNonTransparent);
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+        {
+            REQUIRE(base.at(x, y) == (x
+                ? original_image.at(x, y)
+                : make_pixel(1, 1, 0xFF)));
+        }
+    }
+
+    SECTION("Adding pixels")
+    {
+        res::Image base(width, height);
+        for (auto &pixel : base)
+            pixel = make_pixel(1, 1, 0x80);
+        base.overlay(image, 1, 0, res::Image::OverlayKind::AddSimple);
+        for (const auto y : algo::range(height))
+        for (const auto x : algo::range(width))
+        {
+            auto expected_pixel = make_pixel(1, 1, 0x80);
+            if (x)
+            {
+                const auto &source_pixel = original_image.at(x - 1, y);
+                expected_pixel.b += source_pixel.b;
+                expected_pixel.g += source_pixel.g;
+                expected_pixel.r += source_pixel.r;
+            }
+            REQUIRE(base.at(x, y) == expected_pixel);
+        }
+    }
+}
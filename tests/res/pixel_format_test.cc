@@ -49,6 +49,15 @@ static void test_read(
     compare_pixels(actual_pixel, expected_pixel);
 }
 
+static res::Pixel read_single_pixel(
+    const u8 *&input_ptr, const res::PixelFormat fmt)
+{
+    res::Pixel pixel;
+    res::read_pixels(input_ptr, &pixel, 1, fmt);
+    input_ptr += res::pixel_format_to_bpp(fmt);
+    return pixel;
+}
+
 TEST_CASE("PixelFormat", "[res]")
 {
     SECTION("Pixel format count")
@@ -84,10 +93,10 @@ TEST_CASE("PixelFormat", "[res]")
         REQUIRE(res::pixel_format_to_bpp(res::PixelFormat::RGBnA8888) == 4);
     }
 
+    using PF = res::PixelFormat;
+
     SECTION("Reading")
     {
-        using PF = res::PixelFormat;
-
         test_read(0b0000100011000111, PF::BGR565, {56, 24, 8, 0xFF});
         test_read(0b1000010001100111, PF::BGR555X, {56, 24, 8, 0xFF});
         test_read(0b0000010001100111, PF::BGR555X, {56, 24, 8, 0xFF});
@@ -126,4 +135,26 @@ TEST_CASE("PixelFormat", "[res]")
         test_read(
             0b11111110000000010000001000000011, PF::RGBnA8888, {1, 2, 3, 1});
     }
+
+    SECTION("Reading many pixels at once")
+    {
+        // covers both the vectorized loops and the leftover pixels
+        const auto count = 67;
+        bstr input(count * 4);
+        for (const auto i : algo::range(input.size()))
+            input[i] = (i * 0x9D) ^ (i >> 3);
+
+        for (const auto i : algo::range(static_cast<int>(PF::Count)))
+        {
+            const auto fmt = static_cast<PF>(i);
+            std::vector<res::Pixel> actual_pixels(count);
+            res::read_pixels(input.get<u8>(), actual_pixels, fmt);
+            const auto *input_ptr = input.get<const u8>();
+            for (const auto j : algo::range(count))
+            {
+                const auto expected_pixel = read_single_pixel(input_ptr, fmt);
+                compare_pixels(actual_pixels[j], expected_pixel);
+            }
+        }
+    }
 }
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "test_support/flow_support.h"
+#include "enc/png/png_image_encoder.h"
 #include "flow/file_saver_callback.h"
 #include "flow/parallel_unpacker.h"
 
@@ -37,14 +38,18 @@ std::vector<std::shared_ptr<io::File>> tests::flow_unpack(
             saved_files.push_back(saved_file);
         });
 
+    const enc::png::PngImageEncoder image_encoder;
     const auto name_list = registry.get_decoder_names();
     flow::ParallelUnpackerContext context(
         dummy_logger,
         file_saver,
         registry,
+        image_encoder,
         enable_nested_decoding,
         {},
-        std::set<std::string>(name_list.begin(), name_list.end()));
+        std::set<std::string>(name_list.begin(), name_list.end()),
+        0,
+        "");
 
     flow::ParallelUnpacker unpacker(context);
     unpacker.add_input_file(
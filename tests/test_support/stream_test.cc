@@ -173,6 +173,17 @@ void tests::stream_test(
             tests::compare_binary(result, "xyc"_b);
         }
 
+        SECTION("Positional reads")
+        {
+            stream->write("abcdef"_b).seek(1);
+            tests::compare_binary(stream->read_at(2, 3), "cde"_b);
+            REQUIRE(stream->pos() == 1);
+            tests::compare_binary(stream->read_at(5, 1), "f"_b);
+            tests::compare_binary(stream->read_at(6, 0), ""_b);
+            REQUIRE_THROWS(stream->read_at(5, 2));
+            REQUIRE(stream->read<u8>() == 'b');
+        }
+
         SECTION("Reading integers with endianness conversions")
         {
             stream->write("\x12\x34\x56\x78"_b).seek(0);
@@ -395,4 +395,47 @@ TEST_CASE("bstr", "[core][types]")
             REQUIRE(tmp == "1|2|3|"_b);
         }
     }
+
+    SECTION("Resizing")
+    {
+        SECTION("Growing zero-fills new bytes")
+        {
+            bstr x("abc"_b);
+            x.resize(1);
+            x.resize(3);
+            REQUIRE(x == "a\x00\x00"_b);
+        }
+
+        SECTION("Uninitialized growing keeps existing bytes")
+        {
+            bstr x("abc"_b);
+            x.resize_uninitialized(5);
+            REQUIRE(x.size() == 5);
+            REQUIRE(x.substr(0, 3) == "abc"_b);
+        }
+    }
+
+    SECTION("Recycling large buffers")
+    {
+        const size_t size = 100 * 1024;
+        const u8 *old_ptr;
+        {
+            bstr x(size, 0xFF);
+            old_ptr = x.get<const u8>();
+        }
+
+        SECTION("Buffers are reused")
+        {
+            bstr y;
+            y.resize_uninitialized(size + 1);
+            REQUIRE(y.get<const u8>() == old_ptr);
+        }
+
+        SECTION("Reused buffers are still zero-filled on request")
+        {
+            const bstr y(size);
+            REQUIRE(y == bstr(size, 0));
+            REQUIRE(y.find("\xFF"_b) == bstr::npos);
+        }
+    }
 }
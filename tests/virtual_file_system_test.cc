@@ -0,0 +1,120 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "virtual_file_system.h"
+#include <atomic>
+#include <thread>
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static std::unique_ptr<io::File> make_file(const std::string &content)
+{
+    return std::make_unique<io::File>("", bstr(content));
+}
+
+TEST_CASE("VirtualFileSystem", "[core]")
+{
+    VirtualFileSystem::clear();
+
+    SECTION("Registered files are found by stem, name and path")
+    {
+        VirtualFileSystem::register_file(
+            "dir/Palette.PAL", []() { return make_file("pal"); });
+        REQUIRE(VirtualFileSystem::get_by_stem("palette")->stream.read_to_eof()
+            == "pal"_b);
+        REQUIRE(VirtualFileSystem::get_by_name("PALETTE.pal")
+            ->stream.read_to_eof() == "pal"_b);
+        REQUIRE(VirtualFileSystem::get_by_path("dir/palette.pal")
+            ->stream.read_to_eof() == "pal"_b);
+        REQUIRE(!VirtualFileSystem::get_by_stem("dir"));
+        REQUIRE(!VirtualFileSystem::get_by_name("palette"));
+        REQUIRE(!VirtualFileSystem::get_by_path("palette.pal"));
+    }
+
+    SECTION("Unregistered files are no longer found")
+    {
+        VirtualFileSystem::register_file(
+            "a/mask.bmp", []() { return make_file("a"); });
+        VirtualFileSystem::register_file(
+            "b/mask.bmp", []() { return make_file("b"); });
+        REQUIRE(VirtualFileSystem::get_by_name("mask.bmp")
+            ->stream.read_to_eof() == "a"_b);
+        VirtualFileSystem::unregister_file("A/MASK.BMP");
+        REQUIRE(VirtualFileSystem::get_by_name("mask.bmp")
+            ->stream.read_to_eof() == "b"_b);
+        VirtualFileSystem::unregister_file("b/mask.bmp");
+        REQUIRE(!VirtualFileSystem::get_by_name("mask.bmp"));
+        REQUIRE(!VirtualFileSystem::get_by_stem("mask"));
+    }
+
+    SECTION("Registered directories are searched")
+    {
+        VirtualFileSystem::register_directory("tests/io");
+        REQUIRE(VirtualFileSystem::get_by_name("PATH_TEST.CC"));
+        REQUIRE(VirtualFileSystem::get_by_stem("path_test"));
+        REQUIRE(VirtualFileSystem::get_by_path("tests/io/path_test.cc"));
+        REQUIRE(!VirtualFileSystem::get_by_name("path_test"));
+        VirtualFileSystem::unregister_directory("tests/io");
+        REQUIRE(!VirtualFileSystem::get_by_name("path_test.cc"));
+    }
+
+    SECTION("Factories can look up other files")
+    {
+        VirtualFileSystem::register_file(
+            "key.dat", []() { return make_file("key"); });
+        VirtualFileSystem::register_file(
+            "data.dat",
+            []()
+            {
+                return make_file(VirtualFileSystem::get_by_name("key.dat")
+                    ->stream.read_to_eof().str() + "+data");
+            });
+        REQUIRE(VirtualFileSystem::get_by_name("data.dat")
+            ->stream.read_to_eof() == "key+data"_b);
+    }
+
+    SECTION("Lookups can run concurrently")
+    {
+        VirtualFileSystem::register_file(
+            "file.dat", []() { return make_file("test"); });
+        std::atomic<int> found_count(0);
+        std::vector<std::thread> threads;
+        for (const auto i : algo::range(8))
+        {
+            threads.push_back(std::thread([&]()
+            {
+                for (const auto j : algo::range(100))
+                    if (VirtualFileSystem::get_by_stem("file"))
+                        found_count++;
+            }));
+        }
+        for (auto &thread : threads)
+            thread.join();
+        REQUIRE(found_count == 800);
+    }
+
+    SECTION("Disabled file system ignores registrations")
+    {
+        VirtualFileSystem::disable();
+        VirtualFileSystem::register_file(
+            "file.dat", []() { return make_file("test"); });
+        VirtualFileSystem::enable();
+        REQUIRE(!VirtualFileSystem::get_by_name("file.dat"));
+    }
+}